@@ -29,6 +29,7 @@ Emulator* Emulator::GetEmulatorByID(UINT32 targetSystemID)
 Emulator::Emulator(const char* name)
     : Peripheral(name, name),
       currentRip(NULL),
+      audioMixer(NULL),
       peripheralCount(0)
 {
     memset(peripherals, 0, sizeof(peripherals));
@@ -83,21 +84,13 @@ void Emulator::ReleaseVideo()
     }
 }
 
-void Emulator::InitAudio(AudioMixer* audio, UINT32 sampleRate)
+void Emulator::InitAudio(AudioMixer* audio, UINT32 sampleRate, BOOL stereo)
 {
     if (audio != NULL) {
         audioMixer = audio;
     }
 
-    // TODO: check for an existing audioMixer processor and release it
-    for (UINT16 i = 0; i < GetProcessorCount(); i++) {
-        Processor* p = GetProcessor(i);
-        if (p == audio) {
-            RemoveProcessor(audio);
-        }
-    }
-
-    AddProcessor(audioMixer);
+    audioMixer->setStereo(stereo);
     audioMixer->init(sampleRate);
 }
 
@@ -105,19 +98,29 @@ void Emulator::ReleaseAudio()
 {
     if (audioMixer) {
         audioMixer->release();
-        RemoveProcessor(audioMixer);
         audioMixer = NULL;
     }
 }
 
 void Emulator::Reset()
 {
+    //the audio thread must not be synthesising while the producers reset
+    BOOL asyncAudio = IsAsyncAudio();
+    SetAsyncAudio(FALSE);
+
     processorBus.reset();
     memoryBus.reset();
+    if (audioMixer)
+        audioMixer->reset();
+
+    SetAsyncAudio(asyncAudio);
 }
 
 void Emulator::SetRip(Rip* rip)
 {
+    BOOL asyncAudio = IsAsyncAudio();
+    SetAsyncAudio(FALSE);
+
     if (this->currentRip != NULL) {
         processorBus.removeAll();
         memoryBus.removeAll();
@@ -141,6 +144,8 @@ void Emulator::SetRip(Rip* rip)
 
         InsertPeripheral(currentRip);
     }
+
+    SetAsyncAudio(asyncAudio);
 }
 
 void Emulator::InsertPeripheral(Peripheral* p)
@@ -172,8 +177,10 @@ void Emulator::InsertPeripheral(Peripheral* p)
 
     //audio producers
     count = p->GetAudioProducerCount();
-    for (i = 0; i < count; i++)
+    for (i = 0; i < count; i++) {
         audioMixer->addAudioProducer(p->GetAudioProducer(i));
+        audioMixer->setProducerPan(p->GetAudioProducer(i), p->GetAudioProducerPan(i));
+    }
 
     //input consumers
     count = p->GetInputConsumerCount();
@@ -220,6 +227,62 @@ void Emulator::Run()
 {
     inputConsumerBus.evaluateInputs();
     processorBus.run();
+
+    //mix everything the audio producers played during the frame
+    if (audioMixer)
+        audioMixer->mix();
+}
+
+BOOL Emulator::PullAudio(INT16* buffer, UINT32 count)
+{
+    BOOL frameCompleted = FALSE;
+    if (audioMixer == NULL) {
+        memset(buffer, 0, count * sizeof(INT16));
+        return frameCompleted;
+    }
+
+    //the blocks are synthesised here, on the calling thread
+    BOOL asyncAudio = IsAsyncAudio();
+    SetAsyncAudio(FALSE);
+    UINT64 ticksPerSample = (processorBus.getClockSpeed() + audioMixer->getClockSpeed() - 1) / audioMixer->getClockSpeed();
+    UINT32 channels = audioMixer->getChannelCount();
+
+    //keep the mixer from flushing the frames out from under us when its
+    //buffer fills, and fill the request a buffer at a time
+    audioMixer->setHoldSamples(TRUE);
+    inputConsumerBus.evaluateInputs();
+    UINT32 samplesRead = 0;
+    while (samplesRead < count) {
+        UINT32 blockCount = count - samplesRead;
+        if (blockCount > audioMixer->getSampleSize())
+            blockCount = audioMixer->getSampleSize();
+
+        UINT32 idlePasses = 0;
+        while (audioMixer->getSampleCount() < blockCount) {
+            //the producers run a little behind the bus, so this may take a
+            //couple of passes to fill the block
+            UINT32 samplesNeeded = blockCount - audioMixer->getSampleCount();
+            if (processorBus.runFor(samplesNeeded * ticksPerSample))
+                frameCompleted = TRUE;
+
+            //give up if nothing is producing any audio
+            if (audioMixer->mix() != 0)
+                idlePasses = 0;
+            else if (++idlePasses > 4)
+                break;
+        }
+
+        UINT32 blockRead = audioMixer->readSamples(buffer + (samplesRead * channels), blockCount);
+        samplesRead += blockRead;
+        if (blockRead == 0 || blockRead < blockCount)
+            break;
+    }
+    audioMixer->setHoldSamples(FALSE);
+    SetAsyncAudio(asyncAudio);
+
+    memset(buffer + (samplesRead * channels), 0, (count - samplesRead) * channels * sizeof(INT16));
+
+    return frameCompleted;
 }
 
 void Emulator::Render()
@@ -229,7 +292,22 @@ void Emulator::Render()
 
 void Emulator::FlushAudio()
 {
-    audioMixer->flushAudio();
+    //the audio thread flushes once it has mixed each frame
+    if (audioMixer != NULL && !audioMixer->isAsyncSynthesis())
+        audioMixer->flushAudio();
+}
+
+BOOL Emulator::SetAsyncAudio(BOOL async)
+{
+    if (audioMixer == NULL)
+        return !async;
+
+    return audioMixer->setAsyncSynthesis(async);
+}
+
+BOOL Emulator::IsAsyncAudio()
+{
+    return (audioMixer != NULL && audioMixer->isAsyncSynthesis());
 }
 
 UINT32 Emulator::systemIDs[NUM_EMULATORS] = {
@@ -65,7 +65,13 @@ class Emulator : public Peripheral
 
         void InitVideo(VideoBus* video, UINT32 width, UINT32 height);
         void ReleaseVideo();
-        void InitAudio(AudioMixer* audio, UINT32 sampleRate);
+
+        /**
+         * Sets up the mixer to produce audio at the given rate, as mono
+         * samples or as interleaved stereo pairs with each peripheral's
+         * audio producers placed where they were panned.
+         */
+        void InitAudio(AudioMixer* audio, UINT32 sampleRate, BOOL stereo = FALSE);
         void ReleaseAudio();
 
         void Reset();
@@ -73,6 +79,32 @@ class Emulator : public Peripheral
         void FlushAudio();
         void Render();
 
+        /**
+         * Runs the emulator just far enough to mix count frames of audio (a
+         * sample for each channel of the mixer) and copies them to buffer,
+         * as an alternative to calling Run() and FlushAudio() once per frame
+         * for hosts that want audio in small blocks with less latency.  The
+         * mixer holds at most a thirtieth of a second of audio, so a larger
+         * count is filled that much at a time; frames mixed beyond count
+         * wait in the mixer for the next call.  Asynchronous audio is
+         * suspended while the call runs and then restored.  Without a mixer
+         * nothing runs, and count mono samples of silence are returned.
+         *
+         * @return TRUE if a video frame was completed along the way, in which
+         *         case the host should call Render()
+         */
+        BOOL PullAudio(INT16* buffer, UINT32 count);
+
+        /**
+         * Moves audio synthesis to its own thread, which also flushes the
+         * audio, so that the host no longer needs to call FlushAudio().
+         *
+         * @return FALSE if the current peripherals can only synthesise audio
+         *         on the emulation thread
+         */
+        BOOL SetAsyncAudio(BOOL async);
+        BOOL IsAsyncAudio();
+
         virtual BOOL SaveStateBuffer(void* outBuffer, size_t bufferSize) = 0;
         virtual BOOL LoadStateBuffer(const void* inBuffer, size_t bufferSize) = 0;
 
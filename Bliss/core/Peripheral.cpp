@@ -62,9 +62,10 @@ VideoProducer* Peripheral::GetVideoProducer(UINT16 i)
     return videoProducers[i];
 }
 
-void Peripheral::AddAudioProducer(AudioProducer* ap)
+void Peripheral::AddAudioProducer(AudioProducer* ap, float pan)
 {
     audioProducers[audioProducerCount] = ap;
+    audioProducerPans[audioProducerCount] = pan;
     audioProducerCount++;
 }
 
@@ -78,6 +79,11 @@ AudioProducer* Peripheral::GetAudioProducer(UINT16 i)
     return audioProducers[i];
 }
 
+float Peripheral::GetAudioProducerPan(UINT16 i)
+{
+    return audioProducerPans[i];
+}
+
 void Peripheral::AddInputConsumer(InputConsumer* ic)
 {
     inputConsumers[inputConsumerCount] = ic;
@@ -133,8 +133,10 @@ class Peripheral
          * Adds an audio producer to this peripheral.
          *
          * @param ap the audio producer to add
+         * @param pan where the producer sits between the left (-1) and right
+         *        (+1) channels when the audio output is stereo
          */
-        void AddAudioProducer(AudioProducer* ap);
+        void AddAudioProducer(AudioProducer* ap, float pan = 0.0f);
 
         /**
          * Gets the number of audio producers in this peripheral.
@@ -151,6 +153,14 @@ class Peripheral
          */
         AudioProducer* GetAudioProducer(UINT16 index);
 
+        /**
+         * Gets the stereo pan of the audio producer indicated by an index.
+         *
+         * @param index the index of the audio producer
+         * @return the pan given when the audio producer was added
+         */
+        float GetAudioProducerPan(UINT16 index);
+
         /**
          * Adds an input consumer to this peripheral.
          *
@@ -222,6 +232,7 @@ class Peripheral
         VideoProducer*    videoProducers[MAX_COMPONENTS];
         UINT16            videoProducerCount;
         AudioProducer*    audioProducers[MAX_COMPONENTS];
+        float             audioProducerPans[MAX_COMPONENTS];
         UINT16            audioProducerCount;
         InputConsumer*    inputConsumers[MAX_COMPONENTS];
         UINT16            inputConsumerCount;
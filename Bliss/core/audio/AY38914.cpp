@@ -16,7 +16,8 @@ const INT32 AY38914::amplitudes16Bit[16] = {
 AY38914::AY38914(UINT16 location, AY38914_InputOutput* io0,
         AY38914_InputOutput* io1)
     : Processor("AY-3-8914"),
-      registers(location)
+      registers(location),
+      synthesizer(NULL)
 {
     this->psgIO0 = io0;
     this->psgIO1 = io1;
@@ -70,12 +71,63 @@ INT32 AY38914::getClockDivisor() {
  * in an attempt to tweak it for optimal performance.  Please be careful
  * with any modifications that may adversely affect performance.
  *
- * @return the number of ticks used by the AY38914, always returns 4.
+ * Between transitions of the envelope, noise and tone generators the
+ * output cannot change, so those stretches are emitted as a single run
+ * of samples rather than being stepped through one sample at a time.
+ *
+ * @return the number of ticks used by the AY38914, always a multiple of 16.
  */
 INT32 AY38914::tick(INT32 minimum)
 {
+    if (eventQueue == NULL)
+        return synthesize(minimum);
+
+    //the audio thread will synthesise these samples, so all that is needed
+    //here is the number of ticks that doing so will use
+    logEvent(AUDIO_EVENT_TICK, 0, minimum);
+    INT32 ticksPerSample = (clockDivisor<<4);
+    INT32 samples = (minimum + ticksPerSample - 1) / ticksPerSample;
+    return (samples > 0 ? samples : 1) * ticksPerSample;
+}
+
+INT32 AY38914::synthesize(INT32 minimum)
+{
+	INT32 ticksPerSample = (clockDivisor<<4);
 	INT32 totalTicks = 0;
 	do {
+    //find the number of samples before the next generator expires
+    INT32 nextCounter = envelopeCounter;
+    if (noiseCounter < nextCounter)
+        nextCounter = noiseCounter;
+    if (channel0.toneCounter < nextCounter)
+        nextCounter = channel0.toneCounter;
+    if (channel1.toneCounter < nextCounter)
+        nextCounter = channel1.toneCounter;
+    if (channel2.toneCounter < nextCounter)
+        nextCounter = channel2.toneCounter;
+    INT32 idleSamples = ((nextCounter + clockDivisor - 1) / clockDivisor) - 1;
+
+    if (idleSamples > 0) {
+        //none of the generators change state until then, so just advance
+        //the counters and play the current output for the whole stretch
+        INT32 samplesNeeded = (minimum - totalTicks + ticksPerSample - 1) / ticksPerSample;
+        if (idleSamples > samplesNeeded)
+            idleSamples = (samplesNeeded > 0 ? samplesNeeded : 1);
+
+        INT32 idleClocks = idleSamples * clockDivisor;
+        envelopeCounter -= idleClocks;
+        noiseCounter -= idleClocks;
+        channel0.toneCounter -= idleClocks;
+        channel1.toneCounter -= idleClocks;
+        channel2.toneCounter -= idleClocks;
+
+        updateOutput();
+        audioOutputLine->playRun((INT16)cachedTotalOutput, idleSamples);
+
+        totalTicks += idleSamples * ticksPerSample;
+        continue;
+    }
+
     //iterate the envelope generator
     envelopeCounter -= clockDivisor;
     if (envelopeCounter <= 0) {
@@ -166,6 +218,24 @@ INT32 AY38914::tick(INT32 minimum)
         channel2.isDirty = !channel2.toneDisabled;
     }
 
+    updateOutput();
+    audioOutputLine->playSample((INT16)cachedTotalOutput);
+
+	totalTicks += ticksPerSample;
+
+	} while (totalTicks < minimum);
+
+    //every tick here always uses some multiple of 4 CPU cycles
+    //or 16 NTSC cycles
+	return totalTicks;
+}
+
+/**
+ * Recalculates the samples of any channels whose inputs have changed and
+ * mixes them into the total output sample.
+ */
+void AY38914::updateOutput()
+{
     if (channel0.isDirty) {
         channel0.isDirty = FALSE;
         channel0.cachedSample = amplitudes16Bit[
@@ -209,16 +279,42 @@ INT32 AY38914::tick(INT32 minimum)
         if (cachedTotalOutput > 0x6000)
             cachedTotalOutput = 0x6000 + ((cachedTotalOutput - 0x6000)/6);
     }
+}
 
-    audioOutputLine->playSample((INT16)cachedTotalOutput);
+BOOL AY38914::deferSynthesis()
+{
+    //everything but the register values moves to a copy of this PSG on the
+    //audio thread, which starts from the current state
+    synthesizer = new AY38914(registers.getReadAddress(), NULL, NULL);
+    synthesizer->setState(getState());
+    synthesizer->audioOutputLine = audioOutputLine;
+    copyChannels(synthesizer, this);
+    return TRUE;
+}
 
-	totalTicks += (clockDivisor<<4);
+void AY38914::replayEvent(const AudioEvent* event)
+{
+    if (event->type == AUDIO_EVENT_TICK)
+        synthesizer->synthesize(event->value);
+    else
+        synthesizer->registers.poke(event->location, (UINT16)event->value);
+}
 
-	} while (totalTicks < minimum);
+void AY38914::resumeSynthesis()
+{
+    setState(synthesizer->getState());
+    copyChannels(this, synthesizer);
+    delete synthesizer;
+    synthesizer = NULL;
+}
 
-    //every tick here always uses some multiple of 4 CPU cycles
-    //or 16 NTSC cycles
-	return totalTicks;
+void AY38914::copyChannels(AY38914* to, AY38914* from)
+{
+    //the saved state leaves out the cached channel samples, which can differ
+    //from freshly calculated ones until the channel next changes
+    to->channel0 = from->channel0;
+    to->channel1 = from->channel1;
+    to->channel2 = from->channel2;
 }
 
 AY38914State AY38914::getState()
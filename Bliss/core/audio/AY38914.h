@@ -67,7 +67,16 @@ class AY38914 : public Processor, public AudioProducer
         //registers
         AY38914_Registers      registers;
 
+    protected:
+        BOOL deferSynthesis();
+        void replayEvent(const AudioEvent* event);
+        void resumeSynthesis();
+
     private:
+        INT32 synthesize(INT32 minimum);
+        void updateOutput();
+        static void copyChannels(AY38914* to, AY38914* from);
+
         AY38914_InputOutput*   psgIO0;
         AY38914_InputOutput*   psgIO1;
 
@@ -104,6 +113,10 @@ class AY38914 : public Processor, public AudioProducer
         INT32 random;
         BOOL  noise;
 
+        //the copy of this PSG that synthesises on the audio thread while
+        //synthesis is deferred
+        AY38914* synthesizer;
+
         //output amplitudes for a single channel
         static const INT32 amplitudes16Bit[16];
 };
@@ -163,6 +163,11 @@ void AY38914_Registers::poke(UINT16 location, UINT16 value)
             ay38914->psgIO0->setOutputValue(value);
             break;
     }
+
+    //the register values above are kept here to be read back, but the
+    //audio thread needs the write too if it is doing the synthesis
+    if (ay38914->eventQueue != NULL && location < 0x0E)
+        ay38914->logEvent(AUDIO_EVENT_WRITE, location, value);
 }
 
 UINT16 AY38914_Registers::peek(UINT16 location)
@@ -0,0 +1,165 @@
+
+#include <string.h>
+#include "AudioCapture.h"
+
+AudioCapture::AudioCapture()
+  : file(NULL),
+    wav(FALSE),
+    channels(0),
+    sampleRate(0),
+    dataBytes(0),
+    blocks(NULL),
+    blockFrames(0),
+    framesFilled(0),
+    blocksFilled(0),
+    blocksWritten(0),
+    closing(FALSE)
+{}
+
+AudioCapture::~AudioCapture()
+{
+    close();
+}
+
+BOOL AudioCapture::open(const CHAR* filename, UINT32 channels, UINT32 sampleRate, UINT32 blockFrames)
+{
+    close();
+
+    if (channels == 0 || blockFrames == 0)
+        return FALSE;
+
+    file = fopen(filename, "wb");
+    if (file == NULL)
+        return FALSE;
+
+    size_t length = strlen(filename);
+    wav = !(length >= 4 && strcmp(filename + length - 4, ".raw") == 0);
+
+    this->channels = channels;
+    this->sampleRate = sampleRate;
+    this->blockFrames = blockFrames;
+    dataBytes = 0;
+    framesFilled = 0;
+    blocksFilled = 0;
+    blocksWritten = 0;
+    closing = FALSE;
+
+    //allocate everything up front so that capturing never allocates
+    blocks = new INT16[AUDIO_CAPTURE_BLOCKS * blockFrames * channels];
+    memset(frameCounts, 0, sizeof(frameCounts));
+
+    //the sizes in the header are filled in when the capture is closed
+    if (wav)
+        writeHeader();
+
+    writerThread = std::thread(&AudioCapture::writeBlocks, this);
+    return TRUE;
+}
+
+void AudioCapture::close()
+{
+    if (file == NULL)
+        return;
+
+    //hand over the partly filled block, then wait for everything to be written
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        if (framesFilled) {
+            frameCounts[blocksFilled.load(std::memory_order_relaxed) % AUDIO_CAPTURE_BLOCKS] = framesFilled;
+            blocksFilled.fetch_add(1, std::memory_order_release);
+            framesFilled = 0;
+        }
+        closing = TRUE;
+        wakeCondition.notify_all();
+    }
+    writerThread.join();
+
+    if (wav) {
+        fseek(file, 0, SEEK_SET);
+        writeHeader();
+    }
+    fclose(file);
+    file = NULL;
+
+    delete[] blocks;
+    blocks = NULL;
+}
+
+void AudioCapture::write(const INT16* frames, UINT32 frameCount)
+{
+    while (frameCount) {
+        //if the writer has fallen a whole set of blocks behind, wait for
+        //it rather than leave a gap in the capture
+        UINT32 filled = blocksFilled.load(std::memory_order_relaxed);
+        while (filled - blocksWritten.load(std::memory_order_acquire) == AUDIO_CAPTURE_BLOCKS)
+            std::this_thread::yield();
+
+        UINT32 count = blockFrames - framesFilled;
+        if (count > frameCount)
+            count = frameCount;
+
+        INT16* block = blocks + ((filled % AUDIO_CAPTURE_BLOCKS) * blockFrames * channels);
+        memcpy(block + (framesFilled * channels), frames, count * channels * sizeof(INT16));
+        framesFilled += count;
+        frames += count * channels;
+        frameCount -= count;
+
+        if (framesFilled == blockFrames) {
+            frameCounts[filled % AUDIO_CAPTURE_BLOCKS] = blockFrames;
+            framesFilled = 0;
+
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            blocksFilled.store(filled + 1, std::memory_order_release);
+            wakeCondition.notify_one();
+        }
+    }
+}
+
+void AudioCapture::writeBlocks()
+{
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    for (;;) {
+        UINT32 written = blocksWritten.load(std::memory_order_relaxed);
+        if (written == blocksFilled.load(std::memory_order_acquire)) {
+            if (closing)
+                break;
+            wakeCondition.wait(lock);
+            continue;
+        }
+
+        //the disk write happens without the lock so that the capturing
+        //thread is never held up by it
+        lock.unlock();
+        UINT32 index = written % AUDIO_CAPTURE_BLOCKS;
+        size_t samples = frameCounts[index] * channels;
+        fwrite(blocks + (index * blockFrames * channels), sizeof(INT16), samples, file);
+        dataBytes += (UINT32)(samples * sizeof(INT16));
+        blocksWritten.store(written + 1, std::memory_order_release);
+        lock.lock();
+    }
+}
+
+static void writeLE(FILE* file, UINT32 value, UINT32 bytes)
+{
+    for (UINT32 i = 0; i < bytes; i++)
+        fputc((value >> (i * 8)) & 0xFF, file);
+}
+
+void AudioCapture::writeHeader()
+{
+    fwrite("RIFF", 1, 4, file);
+    writeLE(file, 36 + dataBytes, 4);
+    fwrite("WAVE", 1, 4, file);
+
+    fwrite("fmt ", 1, 4, file);
+    writeLE(file, 16, 4);
+    writeLE(file, 1, 2);
+    writeLE(file, channels, 2);
+    writeLE(file, sampleRate, 4);
+    writeLE(file, sampleRate * channels * sizeof(INT16), 4);
+    writeLE(file, channels * sizeof(INT16), 2);
+    writeLE(file, 16, 2);
+
+    fwrite("data", 1, 4, file);
+    writeLE(file, dataBytes, 4);
+}
@@ -0,0 +1,67 @@
+
+#ifndef AUDIOCAPTURE_H
+#define AUDIOCAPTURE_H
+
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "core/types.h"
+
+//the number of blocks the emulation can fill ahead of the file writes
+#define AUDIO_CAPTURE_BLOCKS    16
+
+/**
+ * Streams interleaved multi-channel 16-bit samples to a WAV file (or a
+ * headerless raw file, if the name ends in ".raw").  The samples are copied
+ * into preallocated blocks and written out by a background thread, so
+ * the thread capturing them does not wait on the disk unless it has
+ * fallen so far behind that every block is full.
+ */
+class AudioCapture
+{
+
+    public:
+        AudioCapture();
+        ~AudioCapture();
+
+        BOOL open(const CHAR* filename, UINT32 channels, UINT32 sampleRate, UINT32 blockFrames);
+        void close();
+        BOOL isOpen() { return file != NULL; }
+
+        /**
+         * Queues frameCount frames, each holding one sample per channel.
+         */
+        void write(const INT16* frames, UINT32 frameCount);
+
+        UINT32 getChannelCount() { return channels; }
+
+    private:
+        void writeBlocks();
+        void writeHeader();
+
+        FILE*   file;
+        BOOL    wav;
+        UINT32  channels;
+        UINT32  sampleRate;
+        UINT32  dataBytes;
+
+        INT16*  blocks;
+        UINT32  blockFrames;
+        UINT32  frameCounts[AUDIO_CAPTURE_BLOCKS];
+        UINT32  framesFilled;
+
+        //blocks are handed to the writer in order; these count the blocks
+        //filled and the blocks written since the capture was opened
+        std::atomic<UINT32>  blocksFilled;
+        std::atomic<UINT32>  blocksWritten;
+
+        std::thread              writerThread;
+        std::mutex               wakeMutex;
+        std::condition_variable  wakeCondition;
+        BOOL                     closing;
+
+};
+
+#endif
@@ -0,0 +1,43 @@
+
+#include <thread>
+#include "AudioEventQueue.h"
+
+AudioEventQueue::AudioEventQueue()
+  : head(0),
+    tail(0),
+    closed(FALSE)
+{}
+
+void AudioEventQueue::wake()
+{
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    wakeCondition.notify_all();
+}
+
+void AudioEventQueue::close()
+{
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    closed = TRUE;
+    wakeCondition.notify_all();
+}
+
+BOOL AudioEventQueue::waitForEvents()
+{
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire)) {
+        if (closed)
+            return FALSE;
+        wakeCondition.wait(lock);
+    }
+
+    return TRUE;
+}
+
+void AudioEventQueue::waitForSpace()
+{
+    //the reader may be asleep waiting for a mix, so wake it to drain the
+    //queue and give it the time to do so
+    wake();
+    while (tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire) == AUDIO_EVENT_QUEUE_SIZE)
+        std::this_thread::yield();
+}
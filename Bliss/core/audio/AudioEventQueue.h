@@ -0,0 +1,82 @@
+
+#ifndef AUDIOEVENTQUEUE_H
+#define AUDIOEVENTQUEUE_H
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "core/types.h"
+
+#define AUDIO_EVENT_QUEUE_SIZE  0x20000
+
+//the producer was ticked, with the minimum ticks in the value
+#define AUDIO_EVENT_TICK        0
+//a register of the producer was written
+#define AUDIO_EVENT_WRITE       1
+//the emulator finished a frame, so the mixer should mix and flush
+#define AUDIO_EVENT_MIX         2
+
+typedef struct _AudioEvent
+{
+    UINT8  type;
+    UINT8  producer;
+    UINT16 location;
+    INT32  value;
+} AudioEvent;
+
+/**
+ * A lock-free queue of audio events from the emulation thread (the only
+ * writer) to the audio synthesis thread (the only reader).  The reader is
+ * only woken when it is asked to mix or the queue fills up, so the writer
+ * normally pays for nothing but a store and an atomic increment.
+ */
+class AudioEventQueue
+{
+
+    public:
+        AudioEventQueue();
+
+        inline void push(UINT8 type, UINT8 producer, UINT16 location, INT32 value) {
+            UINT32 nextTail = tail.load(std::memory_order_relaxed);
+            if (nextTail - head.load(std::memory_order_acquire) == AUDIO_EVENT_QUEUE_SIZE)
+                waitForSpace();
+
+            AudioEvent* event = &events[nextTail & (AUDIO_EVENT_QUEUE_SIZE-1)];
+            event->type = type;
+            event->producer = producer;
+            event->location = location;
+            event->value = value;
+            tail.store(nextTail+1, std::memory_order_release);
+        }
+
+        inline BOOL pop(AudioEvent* event) {
+            UINT32 nextHead = head.load(std::memory_order_relaxed);
+            if (nextHead == tail.load(std::memory_order_acquire))
+                return FALSE;
+
+            *event = events[nextHead & (AUDIO_EVENT_QUEUE_SIZE-1)];
+            head.store(nextHead+1, std::memory_order_release);
+            return TRUE;
+        }
+
+        //called by the writer
+        void wake();
+        void close();
+
+        //called by the reader; returns FALSE once the queue is closed and empty
+        BOOL waitForEvents();
+
+    private:
+        void waitForSpace();
+
+        AudioEvent            events[AUDIO_EVENT_QUEUE_SIZE];
+        std::atomic<UINT32>   head;
+        std::atomic<UINT32>   tail;
+
+        std::mutex               wakeMutex;
+        std::condition_variable  wakeCondition;
+        BOOL                     closed;
+
+};
+
+#endif
@@ -1,47 +1,121 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #include "AudioMixer.h"
 #include "AudioOutputLine.h"
 
 extern UINT64 lcm(UINT64, UINT64);
 
+INT32 AudioMixer::BLEP_KERNEL[BLEP_PHASES][BLEP_WIDTH];
+
 AudioMixer::AudioMixer()
-  : Processor("Audio Mixer"),
+  : clockSpeed(0),
     audioProducerCount(0),
     commonClocksPerTick(0),
+    clocksPerSample(0),
+    rateAdjustment(0),
+    mixedClock(0),
     sampleBuffer(NULL),
     sampleBufferSize(0),
     sampleCount(0),
     sampleSize(0),
-	gain(1.0f)
+    holdSamples(FALSE),
+    outputChannels(1),
+	gain(1.0f),
+    dcBlocker(FALSE),
+    dcBlockerPole(0),
+    lowPassCutoff(0),
+    lowPassCoefficient(0),
+    dither(FALSE),
+    ditherSeed(1),
+    eventQueue(NULL),
+    outputBuffer(NULL),
+    capture(NULL),
+    captureDeltas(NULL),
+    captureFrames(NULL)
 {
 	memset(&audioProducers, 0, sizeof(audioProducers));
+    memset(deltaBuffers, 0, sizeof(deltaBuffers));
+    memset(channelBuffers, 0, sizeof(channelBuffers));
+    initBlepTables();
+}
+
+void AudioMixer::initBlepTables()
+{
+    static BOOL initialized = FALSE;
+    if (initialized)
+        return;
+
+    const double PI = 3.14159265358979323846;
+    //pass band edge as a fraction of the output sample rate
+    const double cutoff = 0.45;
+    const double center = BLEP_WIDTH / 2;
+
+    for (INT32 p = 0; p < BLEP_PHASES; p++) {
+        //the impulse is delayed by half the kernel width, and each phase
+        //places it at a different offset into the first output sample
+        double offset = (p + 0.5) / BLEP_PHASES;
+        double taps[BLEP_WIDTH];
+        double sum = 0;
+        for (INT32 k = 0; k < BLEP_WIDTH; k++) {
+            double x = k - offset - center;
+            if (x <= -center || x >= center) {
+                taps[k] = 0;
+                continue;
+            }
+            double sinc = (x == 0 ? 2.0 * cutoff : sin(2.0 * PI * cutoff * x) / (PI * x));
+            double window = 0.42 + 0.5 * cos(PI * x / center) + 0.08 * cos(2.0 * PI * x / center);
+            taps[k] = sinc * window;
+            sum += taps[k];
+        }
+
+        //quantize and give the rounding error to the center tap so that the
+        //taps of every phase sum exactly to BLEP_UNIT
+        INT32 total = 0;
+        for (INT32 k = 0; k < BLEP_WIDTH; k++) {
+            BLEP_KERNEL[p][k] = (INT32)floor((taps[k] * BLEP_UNIT / sum) + 0.5);
+            total += BLEP_KERNEL[p][k];
+        }
+        BLEP_KERNEL[p][(INT32)center] += BLEP_UNIT - total;
+    }
+
+    initialized = TRUE;
 }
 
 AudioMixer::~AudioMixer()
 {
-    if (sampleBuffer)
-        delete[] sampleBuffer;
+    setAsyncSynthesis(FALSE);
+    stopCapture();
+    if (outputBuffer)
+        delete outputBuffer;
+    AudioMixer::release();
     for (UINT32 i = 0; i < audioProducerCount; i++)
         delete audioProducers[i]->audioOutputLine;
 }
 
 void AudioMixer::addAudioProducer(AudioProducer* p)
 {
+    stopCapture();
     audioProducers[audioProducerCount] = p;
     audioProducers[audioProducerCount]->audioOutputLine =
             new AudioOutputLine();
+    producerGains[audioProducerCount] = DEFAULT_PRODUCER_GAIN;
+    producerPans[audioProducerCount] = 0.0f;
     audioProducerCount++;
 }
 
 void AudioMixer::removeAudioProducer(AudioProducer* p)
 {
+    stopCapture();
     for (UINT32 i = 0; i < audioProducerCount; i++) {
         if (audioProducers[i] == p) {
             delete p->audioOutputLine;
-            for (UINT32 j = i; j < (audioProducerCount-1); j++)
+            for (UINT32 j = i; j < (audioProducerCount-1); j++) {
                 audioProducers[j] = audioProducers[j+1];
+                producerGains[j] = producerGains[j+1];
+                producerPans[j] = producerPans[j+1];
+            }
             audioProducerCount--;
             return;
         }
@@ -54,15 +128,26 @@ void AudioMixer::removeAll()
         removeAudioProducer(audioProducers[0]);
 }
 
-void AudioMixer::resetProcessor()
+void AudioMixer::reset()
 {
     //reset instance data
     commonClocksPerTick = 0;
+    mixedClock = 0;
     sampleCount = 0;
+    memset(mixLevels, 0, sizeof(mixLevels));
+    memset(dcInputs, 0, sizeof(dcInputs));
+    memset(dcOutputs, 0, sizeof(dcOutputs));
+    memset(lowPassLevels, 0, sizeof(lowPassLevels));
 
 	if (sampleBuffer) {
         memset(sampleBuffer, 0, sampleBufferSize);
+        for (UINT32 c = 0; c < MAX_OUTPUT_CHANNELS; c++)
+            memset(deltaBuffers[c], 0, (sampleSize + BLEP_WIDTH) * sizeof(double));
 	}
+    if (capture) {
+        memset(captureDeltas, 0, audioProducerCount * (sampleSize + BLEP_WIDTH) * sizeof(INT64));
+        memset(captureLevels, 0, sizeof(captureLevels));
+    }
 
     //iterate through my audio output lines to determine the common output clock
     UINT64 totalClockSpeed = getClockSpeed();
@@ -73,6 +158,7 @@ void AudioMixer::resetProcessor()
 
     //iterate again to determine the clock factor of each
     commonClocksPerTick = totalClockSpeed / getClockSpeed();
+    clocksPerSample = commonClocksPerTick * (1.0 + rateAdjustment);
     for (UINT32 i = 0; i < audioProducerCount; i++) {
         audioProducers[i]->audioOutputLine->commonClocksPerSample = (totalClockSpeed / audioProducers[i]->getClockSpeed())
 				* audioProducers[i]->getClocksPerSample();
@@ -86,23 +172,41 @@ void AudioMixer::init(UINT32 sampleRate)
 	AudioMixer::release();
 
 	clockSpeed = sampleRate;
-	sampleSize = ( clockSpeed / 60.0 );
-	sampleBufferSize = sampleSize * sizeof(INT16);
-	sampleBuffer = new INT16[sampleSize];
-
-	if (sampleBuffer) {
-		memset(sampleBuffer, 0, sampleBufferSize);
+	rateAdjustment = 0;
+	//the number of samples in a frame is not a whole number and varies
+	//with the rate adjustment, so leave room for two frames to avoid
+	//splitting a frame across flushes
+	sampleSize = ( clockSpeed / 30 );
+	sampleBufferSize = sampleSize * MAX_OUTPUT_CHANNELS * sizeof(INT16);
+	sampleBuffer = new INT16[sampleSize * MAX_OUTPUT_CHANNELS];
+	memset(sampleBuffer, 0, sampleBufferSize);
+	for (UINT32 c = 0; c < MAX_OUTPUT_CHANNELS; c++) {
+		deltaBuffers[c] = new double[sampleSize + BLEP_WIDTH];
+		memset(deltaBuffers[c], 0, (sampleSize + BLEP_WIDTH) * sizeof(double));
+		channelBuffers[c] = new float[sampleSize];
 	}
+
+	//the filter coefficients depend on the sample rate
+	dcBlockerPole = (float)(1.0 - (2.0 * 3.14159265358979323846 * DC_BLOCKER_CUTOFF / clockSpeed));
+	setLowPassCutoff(lowPassCutoff);
 }
 
 void AudioMixer::release()
 {
+    setAsyncSynthesis(FALSE);
+    stopCapture();
     if (sampleBuffer) {
         sampleBufferSize = 0;
         sampleSize = 0;
         sampleCount = 0;
         delete[] sampleBuffer;
         sampleBuffer = NULL;
+        for (UINT32 c = 0; c < MAX_OUTPUT_CHANNELS; c++) {
+            delete[] deltaBuffers[c];
+            deltaBuffers[c] = NULL;
+            delete[] channelBuffers[c];
+            channelBuffers[c] = NULL;
+        }
     }
 }
 
@@ -111,53 +215,416 @@ INT32 AudioMixer::getClockSpeed()
 	return clockSpeed;
 }
 
-INT32 AudioMixer::tick(INT32 minimum)
+void AudioMixer::setRateAdjustment(double adjustment)
+{
+    if (adjustment > MAX_RATE_ADJUSTMENT)
+        adjustment = MAX_RATE_ADJUSTMENT;
+    else if (adjustment < -MAX_RATE_ADJUSTMENT)
+        adjustment = -MAX_RATE_ADJUSTMENT;
+
+    rateAdjustment = adjustment;
+    clocksPerSample = commonClocksPerTick * (1.0 + rateAdjustment);
+}
+
+void AudioMixer::setBufferFill(UINT32 bufferedSamples, UINT32 targetSamples)
 {
-	// TODO: assert if sampleCount >= sampleSize
+    if (targetSamples == 0)
+        return;
 
-    for (int totalTicks = 0; totalTicks < minimum; totalTicks++) {
-        //mix and flush the sample buffers
-        INT64 totalSample = 0;
+    //a fuller queue stretches the sample period so that fewer are produced
+    double error = ((double)bufferedSamples - targetSamples) / targetSamples;
+    setRateAdjustment(error * MAX_RATE_ADJUSTMENT);
+}
+
+void AudioMixer::setProducerGain(AudioProducer* p, float gain)
+{
+    for (UINT32 i = 0; i < audioProducerCount; i++) {
+        if (audioProducers[i] == p)
+            producerGains[i] = gain;
+    }
+}
+
+void AudioMixer::setProducerPan(AudioProducer* p, float pan)
+{
+    if (pan > 1.0f)
+        pan = 1.0f;
+    else if (pan < -1.0f)
+        pan = -1.0f;
+
+    for (UINT32 i = 0; i < audioProducerCount; i++) {
+        if (audioProducers[i] == p)
+            producerPans[i] = pan;
+    }
+}
+
+void AudioMixer::setLowPassCutoff(float cutoff)
+{
+    lowPassCutoff = cutoff;
+    if (cutoff <= 0 || clockSpeed <= 0)
+        lowPassCoefficient = 0;
+    else
+        lowPassCoefficient = (float)(1.0 - exp(-2.0 * 3.14159265358979323846 * cutoff / clockSpeed));
+}
+
+BOOL AudioMixer::setAsyncSynthesis(BOOL async)
+{
+    if (async == isAsyncSynthesis())
+        return TRUE;
+
+    if (async) {
+        eventQueue = new AudioEventQueue();
         for (UINT32 i = 0; i < audioProducerCount; i++) {
-            AudioOutputLine* nextLine = audioProducers[i]->audioOutputLine;
-
-            INT64 missingClocks = (this->commonClocksPerTick - nextLine->commonClockCounter);
-            INT64 sampleToUse = (missingClocks < 0 ? nextLine->previousSample : nextLine->currentSample);
-
-            //account for when audio producers idle by adding enough samples to each producer's buffer
-			//to fill the time since last sample calculation
-            INT64 missingSampleCount = (missingClocks / nextLine->commonClocksPerSample);
-            if (missingSampleCount != 0) {
-			    nextLine->sampleBuffer += missingSampleCount * sampleToUse * nextLine->commonClocksPerSample;
-                nextLine->commonClockCounter += missingSampleCount * nextLine->commonClocksPerSample;
-                missingClocks -= missingSampleCount * nextLine->commonClocksPerSample;
+            audioProducers[i]->eventQueue = eventQueue;
+            audioProducers[i]->eventProducer = (UINT8)i;
+            if (!audioProducers[i]->deferSynthesis()) {
+                //hand synthesis back to the producers that took it
+                audioProducers[i]->eventQueue = NULL;
+                while (i-- > 0) {
+                    audioProducers[i]->resumeSynthesis();
+                    audioProducers[i]->eventQueue = NULL;
+                }
+                delete eventQueue;
+                eventQueue = NULL;
+                return FALSE;
             }
-			INT64 partialSample = sampleToUse * missingClocks;
+        }
+        synthesisThread = std::thread(&AudioMixer::synthesize, this);
+    }
+    else {
+        //let the audio thread replay everything logged so far
+        eventQueue->close();
+        synthesisThread.join();
+        for (UINT32 i = 0; i < audioProducerCount; i++) {
+            audioProducers[i]->resumeSynthesis();
+            audioProducers[i]->eventQueue = NULL;
+        }
+        delete eventQueue;
+        eventQueue = NULL;
+    }
 
-            //calculate the sample for this line
-            totalSample += (INT16)((nextLine->sampleBuffer + partialSample) / commonClocksPerTick);
+    return TRUE;
+}
 
-            //clear the sample buffer for this line
-            nextLine->sampleBuffer = -partialSample;
-            nextLine->commonClockCounter = -missingClocks;
+void AudioMixer::synthesize()
+{
+    AudioEvent event;
+    while (eventQueue->waitForEvents()) {
+        while (eventQueue->pop(&event)) {
+            if (event.type == AUDIO_EVENT_MIX) {
+                mixLines();
+                flushAudio();
+            }
+            else
+                audioProducers[event.producer]->replayEvent(&event);
         }
+    }
+}
 
-        if (audioProducerCount > 1) {
-            totalSample = totalSample / audioProducerCount;
-        }
+/**
+ * Mixes everything the audio producers have played since the last call,
+ * up to the point that all of them have reached, into the sample buffer.
+ * Whatever they have played beyond that point is kept for the next call.
+ *
+ * While synthesis is asynchronous the audio thread is only asked to mix,
+ * and flushes the audio itself when it has.
+ *
+ * @return the number of samples mixed
+ */
+UINT32 AudioMixer::mix()
+{
+    if (eventQueue == NULL)
+        return mixLines();
 
-        sampleBuffer[sampleCount++] = clipSample((totalSample * this->gain) + 0.5f);
+    eventQueue->push(AUDIO_EVENT_MIX, 0, 0, 0);
+    eventQueue->wake();
+    return 0;
+}
 
-        if (sampleCount == sampleSize) {
+UINT32 AudioMixer::mixLines()
+{
+    if (audioProducerCount == 0 || commonClocksPerTick == 0 || sampleBuffer == NULL)
+        return 0;
+
+    //find the latest clock that every line has played up to
+    INT64 endClock = audioProducers[0]->audioOutputLine->clock;
+    for (UINT32 i = 1; i < audioProducerCount; i++) {
+        if (audioProducers[i]->audioOutputLine->clock < endClock)
+            endClock = audioProducers[i]->audioOutputLine->clock;
+    }
+
+    //carry the fraction of a sample left over into the next call so that
+    //the number of samples tracks the emulated time exactly
+    INT64 samplesToMix = (INT64)((endClock - mixedClock) / clocksPerSample);
+    UINT32 samplesMixed = 0;
+    while (samplesToMix > 0) {
+        UINT32 count = sampleSize - sampleCount;
+        if (count == 0)
+            break;  //full and holding for readSamples()
+        if (count > samplesToMix)
+            count = (UINT32)samplesToMix;
+
+        mixBlock(count);
+        samplesMixed += count;
+        samplesToMix -= count;
+
+        if (sampleCount == sampleSize && !holdSamples) {
             flushAudio();
         }
     }
 
-    return minimum;
+    INT64 mixedClocks = (INT64)mixedClock;
+    for (UINT32 i = 0; i < audioProducerCount; i++)
+        audioProducers[i]->audioOutputLine->discardMixed(mixedClocks);
+    mixedClock -= mixedClocks;
+
+    return samplesMixed;
+}
+
+void AudioMixer::mixBlock(UINT32 count)
+{
+    const double blockEnd = mixedClock + (count * clocksPerSample);
+    const double samplesPerClock = 1.0 / clocksPerSample;
+
+    //add a band-limited step to the delta buffer of each channel for each
+    //level change, weighted by the gain and pan of the producer
+    for (UINT32 i = 0; i < audioProducerCount; i++) {
+        double weights[MAX_OUTPUT_CHANNELS];
+        double producerScale = (double)gain * producerGains[i] / BLEP_UNIT;
+        if (outputChannels == 1)
+            weights[0] = producerScale;
+        else {
+            weights[0] = producerScale * (producerPans[i] > 0 ? 1.0 - producerPans[i] : 1.0);
+            weights[1] = producerScale * (producerPans[i] < 0 ? 1.0 + producerPans[i] : 1.0);
+        }
+
+        AudioOutputLine* nextLine = audioProducers[i]->audioOutputLine;
+        for (; nextLine->deltasMixed < nextLine->deltaCount; nextLine->deltasMixed++) {
+            const AudioDelta* step = &nextLine->deltas[nextLine->deltasMixed];
+            if (step->clock >= blockEnd)
+                break;
+
+            double position = (step->clock > mixedClock ? (step->clock - mixedClock) * samplesPerClock : 0);
+            UINT32 s = (UINT32)position;
+            if (s >= count)
+                s = count-1;
+            const INT32* kernel = BLEP_KERNEL[(INT32)((position - s) * BLEP_PHASES) & (BLEP_PHASES-1)];
+            for (UINT32 c = 0; c < outputChannels; c++) {
+                double* deltas = deltaBuffers[c] + s;
+                const double delta = step->delta * weights[c];
+                for (INT32 k = 0; k < BLEP_WIDTH; k++)
+                    deltas[k] += delta * kernel[k];
+            }
+
+            if (capture) {
+                INT64* deltas = captureDeltas + (i * (sampleSize + BLEP_WIDTH)) + s;
+                for (INT32 k = 0; k < BLEP_WIDTH; k++)
+                    deltas[k] += (INT64)step->delta * kernel[k];
+            }
+        }
+    }
+
+    //integrate the deltas into a block of levels for each channel, and
+    //carry the tails of the last steps over into the next block
+    for (UINT32 c = 0; c < outputChannels; c++) {
+        double* deltas = deltaBuffers[c];
+        float* levels = channelBuffers[c];
+        double level = mixLevels[c];
+        for (UINT32 s = 0; s < count; s++) {
+            level += deltas[s];
+            levels[s] = (float)level;
+        }
+        mixLevels[c] = level;
+
+        memmove(deltas, deltas + count, BLEP_WIDTH * sizeof(double));
+        memset(deltas + BLEP_WIDTH, 0, count * sizeof(double));
+    }
+
+    postFilter(count);
+    quantise(count);
+
+    if (capture)
+        captureBlock(count);
+
+    sampleCount += count;
+    mixedClock = blockEnd;
+}
+
+/**
+ * Runs the optional filters over the levels of the block.  The filters
+ * feed back on themselves from one sample to the next, so each channel
+ * is filtered as a tight loop of its own.
+ */
+void AudioMixer::postFilter(UINT32 count)
+{
+    for (UINT32 c = 0; c < outputChannels; c++) {
+        float* levels = channelBuffers[c];
+
+        if (dcBlocker) {
+            float input = dcInputs[c];
+            float output = dcOutputs[c];
+            for (UINT32 s = 0; s < count; s++) {
+                output = levels[s] - input + (dcBlockerPole * output);
+                input = levels[s];
+                levels[s] = output;
+            }
+            dcInputs[c] = input;
+            dcOutputs[c] = output;
+        }
+
+        if (lowPassCoefficient > 0) {
+            float output = lowPassLevels[c];
+            for (UINT32 s = 0; s < count; s++) {
+                output += lowPassCoefficient * (levels[s] - output);
+                levels[s] = output;
+            }
+            lowPassLevels[c] = output;
+        }
+    }
+}
+
+/**
+ * Rounds the levels of the block to 16-bit samples, interleaving the
+ * channels into the sample buffer.
+ */
+void AudioMixer::quantise(UINT32 count)
+{
+    for (UINT32 c = 0; c < outputChannels; c++) {
+        float* levels = channelBuffers[c];
+
+        if (dither) {
+            //the sum of two uniform values gives a triangular distribution
+            //one step wide either side of zero
+            const float scale = 1.0f / 4294967296.0f;
+            for (UINT32 s = 0; s < count; s++) {
+                ditherSeed = (ditherSeed * 1664525) + 1013904223;
+                float noise = (INT32)ditherSeed * scale;
+                ditherSeed = (ditherSeed * 1664525) + 1013904223;
+                levels[s] += noise + ((INT32)ditherSeed * scale);
+            }
+        }
+
+        //clamp first so that rounding by truncation of a positive value is
+        //safe, which keeps this loop simple enough to be vectorised
+        INT16* out = sampleBuffer + (sampleCount * outputChannels) + c;
+        for (UINT32 s = 0; s < count; s++) {
+            float level = levels[s];
+            level = (level > 32767.0f ? 32767.0f : (level < -32768.0f ? -32768.0f : level));
+            out[s * outputChannels] = (INT16)((INT32)(level + 32768.5f) - 32768);
+        }
+    }
+}
+
+UINT32 AudioMixer::readSamples(INT16* out, UINT32 count)
+{
+    if (count > sampleCount)
+        count = sampleCount;
+
+    memcpy(out, sampleBuffer, count * outputChannels * sizeof(INT16));
+    sampleCount -= count;
+    memmove(sampleBuffer, sampleBuffer + (count * outputChannels), sampleCount * outputChannels * sizeof(INT16));
+
+    return count;
+}
+
+BOOL AudioMixer::startCapture(const CHAR* filename)
+{
+    stopCapture();
+    if (audioProducerCount == 0 || sampleBuffer == NULL)
+        return FALSE;
+
+    //the capture is fed from mixBlock, which the audio thread may be running
+    BOOL async = isAsyncSynthesis();
+    setAsyncSynthesis(FALSE);
+
+    AudioCapture* newCapture = new AudioCapture();
+    if (newCapture->open(filename, audioProducerCount, clockSpeed, sampleSize)) {
+        UINT32 stride = sampleSize + BLEP_WIDTH;
+        captureDeltas = new INT64[audioProducerCount * stride];
+        memset(captureDeltas, 0, audioProducerCount * stride * sizeof(INT64));
+        captureFrames = new INT16[audioProducerCount * sampleSize];
+
+        //start each track from the level its line has reached in the mix,
+        //which is where it is now less the steps not yet mixed
+        for (UINT32 i = 0; i < audioProducerCount; i++) {
+            AudioOutputLine* line = audioProducers[i]->audioOutputLine;
+            INT64 level = line->currentSample;
+            for (UINT32 j = line->deltasMixed; j < line->deltaCount; j++)
+                level -= line->deltas[j].delta;
+            captureLevels[i] = level * BLEP_UNIT;
+        }
+        capture = newCapture;
+    }
+    else
+        delete newCapture;
+
+    setAsyncSynthesis(async);
+    return (capture != NULL);
+}
+
+void AudioMixer::stopCapture()
+{
+    if (capture == NULL)
+        return;
+
+    BOOL async = isAsyncSynthesis();
+    setAsyncSynthesis(FALSE);
+
+    delete capture;
+    capture = NULL;
+    delete[] captureDeltas;
+    captureDeltas = NULL;
+    delete[] captureFrames;
+    captureFrames = NULL;
+
+    setAsyncSynthesis(async);
+}
+
+void AudioMixer::captureBlock(UINT32 count)
+{
+    //each track is integrated just like the mix, but on its own and
+    //without the gain and pan of its producer
+    const float scale = this->gain / BLEP_UNIT;
+    const UINT32 stride = sampleSize + BLEP_WIDTH;
+    for (UINT32 i = 0; i < audioProducerCount; i++) {
+        INT64* deltas = captureDeltas + (i * stride);
+        INT64 level = captureLevels[i];
+        for (UINT32 s = 0; s < count; s++) {
+            level += deltas[s];
+            captureFrames[(s * audioProducerCount) + i] = clipSample((INT64)((level * scale) + 0.5f));
+        }
+        captureLevels[i] = level;
+
+        memmove(deltas, deltas + count, BLEP_WIDTH * sizeof(INT64));
+        memset(deltas + BLEP_WIDTH, 0, count * sizeof(INT64));
+    }
+
+    capture->write(captureFrames, count);
+}
+
+void AudioMixer::setOutputBuffer(UINT32 capacity)
+{
+    //the ring is written by whichever thread flushes, so keep that one
+    //still while it is replaced
+    BOOL async = isAsyncSynthesis();
+    setAsyncSynthesis(FALSE);
+
+    if (outputBuffer) {
+        delete outputBuffer;
+        outputBuffer = NULL;
+    }
+    if (capacity)
+        outputBuffer = new AudioRingBuffer(capacity);
+
+    setAsyncSynthesis(async);
 }
 
 void AudioMixer::flushAudio()
 {
+    if (outputBuffer) {
+        outputBuffer->write(sampleBuffer, sampleCount * outputChannels);
+        setBufferFill(outputBuffer->getAvailable() / outputChannels, outputBuffer->getCapacity() / (2 * outputChannels));
+    }
+
     //the platform subclass must copy the sampleBuffer to the device
     //before calling here (which discards the contents of sampleBuffer)
     sampleCount = 0;
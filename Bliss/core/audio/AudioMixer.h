@@ -2,18 +2,50 @@
 #ifndef AUDIOMIXER_H
 #define AUDIOMIXER_H
 
+#include <thread>
 #include "AudioProducer.h"
+#include "AudioEventQueue.h"
+#include "AudioRingBuffer.h"
+#include "AudioCapture.h"
 #include "core/types.h"
-#include "core/cpu/Processor.h"
 
 #define MAX_AUDIO_PRODUCERS 10
 
+//the band-limited step kernel, tabulated at BLEP_PHASES sub-sample offsets
+//with taps that sum to BLEP_UNIT so that steps integrate back to exact levels
+#define BLEP_PHASES     64
+#define BLEP_WIDTH      16
+#define BLEP_UNIT_BITS  15
+#define BLEP_UNIT       (1 << BLEP_UNIT_BITS)
+
+//the largest change to the output sample rate the rate control may make
+#define MAX_RATE_ADJUSTMENT 0.005
+
+//the output is mono or interleaved stereo
+#define MAX_OUTPUT_CHANNELS 2
+
+//the corner of the optional DC blocker, in Hz
+#define DC_BLOCKER_CUTOFF   20.0
+
+//the gain each producer starts with, leaving 6 dB of headroom so that two
+//producers playing at full scale together still fit in the output samples
+#define DEFAULT_PRODUCER_GAIN   0.5f
+
 template<typename A, typename W> class EmulatorTmpl;
 
-class AudioMixer : public Processor
+/**
+ * Mixes the output lines of all of the audio producers into the output
+ * sample buffer.  The producers record the steps in their output levels
+ * as they run, and when the emulator has finished running a frame the
+ * mixer adds a band-limited step for each of them, weighted by the gain
+ * and pan of the producer, to the delta buffer of each output channel and
+ * integrates those into blocks of floating point levels.  The blocks then
+ * run through the optional post-filters and are quantised to the 16-bit
+ * output samples.
+ */
+class AudioMixer
 {
 
-    friend class ProcessorBus;
     friend class AudioOutputLine;
 
     public:
@@ -24,11 +56,56 @@ class AudioMixer : public Processor
             return sample > 32767 ? 32767 : sample < -32768 ? -32768 : (INT16)sample;
         }
 
-        virtual void resetProcessor();
+        /**
+         * Sets whether the output samples are mono or interleaved stereo
+         * pairs.  Set this before the Emulator initialises the audio.
+         */
+        void setStereo(BOOL stereo) { outputChannels = (stereo ? 2 : 1); }
+        UINT32 getChannelCount() { return outputChannels; }
+
+        virtual void reset();
         INT32 getClockSpeed();
-        INT32 tick(INT32 minimum);
+        UINT32 mix();
         virtual void flushAudio();
 
+        /**
+         * Removes up to count mixed frames (a sample for each channel) from
+         * the front of the sample buffer, for hosts that pull audio rather
+         * than being flushed to.
+         *
+         * @return the number of frames copied to out
+         */
+        UINT32 readSamples(INT16* out, UINT32 count);
+        UINT32 getSampleCount() { return sampleCount; }
+        UINT32 getSampleSize() { return sampleSize; }
+
+        /**
+         * While holding, mixing stops when the sample buffer is full rather
+         * than flushing it, so that every frame waits for readSamples().  The
+         * steps beyond that point stay on the output lines for the next mix.
+         */
+        void setHoldSamples(BOOL hold) { holdSamples = hold; }
+
+        /**
+         * Gives the mixer a ring buffer of the given capacity in samples (or
+         * removes it, for zero) that each flush writes to.  The host's audio
+         * device thread drains it with getOutputBuffer()->read(), without
+         * locks, and the mixer adjusts its rate to keep the ring half full.
+         * The device thread must stop reading while the ring is replaced.
+         */
+        void setOutputBuffer(UINT32 capacity);
+        AudioRingBuffer* getOutputBuffer() { return outputBuffer; }
+
+        /**
+         * Captures the output of each audio producer, before it is mixed,
+         * as a separate channel of a WAV (or ".raw") file, in the order the
+         * producers were added.  Adding or removing a producer stops the
+         * capture, so start it once the peripherals are in place.
+         */
+        BOOL startCapture(const CHAR* filename);
+        void stopCapture();
+        BOOL isCapturing() { return capture != NULL; }
+
         //only to be called by the Emulator
         virtual void init(UINT32 sampleRate);
         virtual void release();
@@ -37,11 +114,64 @@ class AudioMixer : public Processor
         void removeAudioProducer(AudioProducer*);
         void removeAll();
 
+        /**
+         * Moves the synthesis of every audio producer to a dedicated audio
+         * thread, which replays the ticks and register writes that they log
+         * while the emulation thread runs and then mixes and flushes each
+         * frame.  The output is identical to synchronous synthesis.  This
+         * fails, leaving synthesis where it was, if any producer does not
+         * support it.
+         *
+         * The audio thread must be stopped around anything that touches the
+         * producers' synthesis state, such as resets and save states.
+         */
+        BOOL setAsyncSynthesis(BOOL async);
+        BOOL isAsyncSynthesis() { return eventQueue != NULL; }
+
         void setGain(float g) {
             this->gain = g;
         }
 
+        /**
+         * Sets the gain of one producer, and where it sits between the left
+         * (-1) and right (+1) channels when the output is stereo.  A producer
+         * at the center plays at full gain in both.  Producers start with
+         * DEFAULT_PRODUCER_GAIN, at the center.
+         */
+        void setProducerGain(AudioProducer* p, float gain);
+        void setProducerPan(AudioProducer* p, float pan);
+
+        /**
+         * Turns the post-filters on or off.  They all default to off.  The DC
+         * blocker removes any constant offset, the low-pass filter models the
+         * RC filter on the output of the console (a cutoff of zero bypasses
+         * it) and dithering adds triangular noise of one step before the
+         * samples are quantised to 16 bits.
+         */
+        void setDCBlocker(BOOL enabled) { dcBlocker = enabled; }
+        void setLowPassCutoff(float cutoff);
+        void setDither(BOOL enabled) { dither = enabled; }
+
+        /**
+         * Stretches (positive) or shrinks (negative) the output sample period
+         * by the given fraction, up to MAX_RATE_ADJUSTMENT either way, so that
+         * a host can track its audio device clock without dropping samples.
+         */
+        void setRateAdjustment(double adjustment);
+
+        /**
+         * Sets the rate adjustment in proportion to how far the host's queue
+         * of output samples is from the level it is aiming for.  Hosts that
+         * call this after every flush will keep the queue near its target.
+         */
+        void setBufferFill(UINT32 bufferedSamples, UINT32 targetSamples);
+
     protected:
+        UINT32 mixLines();
+        void mixBlock(UINT32 count);
+        void postFilter(UINT32 count);
+        void quantise(UINT32 count);
+
         //output info
         INT32 clockSpeed;
 
@@ -49,12 +179,54 @@ class AudioMixer : public Processor
         UINT32             audioProducerCount;
 
         INT64 commonClocksPerTick;
+        double clocksPerSample;
+        double rateAdjustment;
+        double mixedClock;
+        double* deltaBuffers[MAX_OUTPUT_CHANNELS];
+        double mixLevels[MAX_OUTPUT_CHANNELS];
+        float* channelBuffers[MAX_OUTPUT_CHANNELS];
         INT16* sampleBuffer;
         UINT32 sampleBufferSize;
         UINT32 sampleCount;
         UINT32 sampleSize;
+        BOOL holdSamples;
+        UINT32 outputChannels;
 
         float gain;
+        float producerGains[MAX_AUDIO_PRODUCERS];
+        float producerPans[MAX_AUDIO_PRODUCERS];
+
+        //post-filter settings and the state each keeps per channel
+        BOOL  dcBlocker;
+        float dcBlockerPole;
+        float dcInputs[MAX_OUTPUT_CHANNELS];
+        float dcOutputs[MAX_OUTPUT_CHANNELS];
+        float lowPassCutoff;
+        float lowPassCoefficient;
+        float lowPassLevels[MAX_OUTPUT_CHANNELS];
+        BOOL  dither;
+        UINT32 ditherSeed;
+
+    private:
+        void synthesize();
+
+        static void initBlepTables();
+
+        //the queue of logged events and the thread that replays them while
+        //synthesis is asynchronous
+        AudioEventQueue* eventQueue;
+        std::thread      synthesisThread;
+
+        AudioRingBuffer* outputBuffer;
+
+        //the unmixed line of each producer while capturing
+        void captureBlock(UINT32 count);
+        AudioCapture*    capture;
+        INT64*           captureDeltas;
+        INT64            captureLevels[MAX_AUDIO_PRODUCERS];
+        INT16*           captureFrames;
+
+        static INT32 BLEP_KERNEL[BLEP_PHASES][BLEP_WIDTH];
 };
 
 #endif
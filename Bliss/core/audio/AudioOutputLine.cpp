@@ -1,31 +1,61 @@
 
+#include <string.h>
 #include "AudioOutputLine.h"
 #include "AudioMixer.h"
 
+#define INITIAL_DELTA_CAPACITY 4096
+
 AudioOutputLine::AudioOutputLine()
-  : sampleBuffer(0),
-	previousSample(0),
-	currentSample(0),
-	commonClockCounter(0),
-	commonClocksPerSample(0)
+  : deltas(new AudioDelta[INITIAL_DELTA_CAPACITY]),
+    deltaCount(0),
+    deltaCapacity(INITIAL_DELTA_CAPACITY),
+    deltasMixed(0),
+    currentSample(0),
+    clock(0),
+    commonClocksPerSample(0)
 {}
 
-void AudioOutputLine::reset()
+AudioOutputLine::~AudioOutputLine()
 {
-    sampleBuffer = 0;
-	previousSample = 0;
-	currentSample = 0;
-	commonClockCounter = 0;
-	commonClocksPerSample = 0;
+    delete[] deltas;
 }
 
-void AudioOutputLine::playSample(INT16 sample)
+void AudioOutputLine::reset()
 {
-    sampleBuffer += currentSample * commonClocksPerSample;
-    commonClockCounter += commonClocksPerSample;
-	previousSample = currentSample;
-	currentSample = sample;
+    deltaCount = 0;
+    deltasMixed = 0;
+    currentSample = 0;
+    clock = 0;
+    commonClocksPerSample = 0;
 }
 
+void AudioOutputLine::addDelta(INT16 sample)
+{
+    if (deltaCount == deltaCapacity) {
+        //the mixer has fallen behind (or is not running), so make room
+        AudioDelta* grown = new AudioDelta[deltaCapacity*2];
+        memcpy(grown, deltas, deltaCount * sizeof(AudioDelta));
+        delete[] deltas;
+        deltas = grown;
+        deltaCapacity *= 2;
+    }
 
+    deltas[deltaCount].clock = clock;
+    deltas[deltaCount].delta = sample - currentSample;
+    deltaCount++;
+    currentSample = sample;
+}
 
+void AudioOutputLine::discardMixed(INT64 mixedClock)
+{
+    //drop the steps that have been mixed and rebase the rest so that
+    //the timestamps stay relative to the start of the next block
+    UINT32 remaining = deltaCount - deltasMixed;
+    for (UINT32 i = 0; i < remaining; i++) {
+        deltas[i].clock = deltas[deltasMixed+i].clock - mixedClock;
+        deltas[i].delta = deltas[deltasMixed+i].delta;
+    }
+    deltaCount = remaining;
+    deltasMixed = 0;
+    clock -= mixedClock;
+}
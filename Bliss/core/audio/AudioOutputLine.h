@@ -4,26 +4,57 @@
 
 #include "core/types.h"
 
+/**
+ * A step in the output level of an audio line, timestamped in the common
+ * clock of the mixer relative to the start of the block being mixed.
+ */
+typedef struct _AudioDelta
+{
+    INT64 clock;
+    INT32 delta;
+} AudioDelta;
+
 class AudioOutputLine
 {
 
     friend class AudioMixer;
 
     public:
-        void playSample(INT16 sample);
+        inline void playSample(INT16 sample) {
+            clock += commonClocksPerSample;
+            if (sample != currentSample)
+                addDelta(sample);
+        }
+
+        inline void playRun(INT16 sample, INT32 count) {
+            //equivalent to calling playSample(sample) count times in a row
+            if (count <= 0)
+                return;
+            clock += commonClocksPerSample;
+            if (sample != currentSample)
+                addDelta(sample);
+            clock += (count - 1) * commonClocksPerSample;
+        }
 
     private:
         AudioOutputLine();
+        ~AudioOutputLine();
         void reset();
+        void addDelta(INT16 sample);
+        void discardMixed(INT64 mixedClock);
 
-        INT64 sampleBuffer;
-		INT64 previousSample;
-		INT64 currentSample;
-		INT64 commonClockCounter;
-		INT64 commonClocksPerSample;
+        //the level steps played since the last block was mixed
+        AudioDelta* deltas;
+        UINT32 deltaCount;
+        UINT32 deltaCapacity;
+        UINT32 deltasMixed;
+
+        //the level after the most recent step
+        INT16 currentSample;
+        INT64 clock;
+        INT64 commonClocksPerSample;
 
 };
 
 #endif
 
-
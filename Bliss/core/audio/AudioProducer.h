@@ -3,6 +3,7 @@
 #define AUDIOPRODUCER_H
 
 #include "AudioOutputLine.h"
+#include "AudioEventQueue.h"
 
 /**
  * This interface is implemented by any piece of hardware that produces audio.
@@ -13,14 +14,44 @@ class AudioProducer
     friend class AudioMixer;
 
 public:
-    AudioProducer() : audioOutputLine(NULL) {}
+    AudioProducer() : audioOutputLine(NULL), eventQueue(NULL), eventProducer(0) {}
 
     virtual INT32 getClockSpeed() = 0;
 	virtual INT32 getClocksPerSample() = 0;
 
     protected:
+        /**
+         * Asks the producer to stop synthesising on the emulation thread, and
+         * instead log its ticks and register writes to the queue for the
+         * mixer to replay on the audio thread.  Producers that can do this
+         * keep just enough state on the emulation thread to answer register
+         * reads.
+         *
+         * @return FALSE if the producer only supports synchronous synthesis
+         */
+        virtual BOOL deferSynthesis() { return FALSE; }
+
+        /**
+         * Replays an event logged by this producer.  Called on the audio thread.
+         */
+        virtual void replayEvent(const AudioEvent*) {}
+
+        /**
+         * Takes back synthesis once the audio thread has replayed everything
+         * that was logged.
+         */
+        virtual void resumeSynthesis() {}
+
+        inline void logEvent(UINT8 type, UINT16 location, INT32 value) {
+            eventQueue->push(type, eventProducer, location, value);
+        }
+
         AudioOutputLine* audioOutputLine;
 
+        //where to log events while synthesis is deferred, or NULL
+        AudioEventQueue* eventQueue;
+        UINT8            eventProducer;
+
 };
 
 #endif
@@ -0,0 +1,67 @@
+
+#include <string.h>
+#include "AudioRingBuffer.h"
+
+AudioRingBuffer::AudioRingBuffer(UINT32 capacity)
+  : writeIndex(0),
+    overruns(0),
+    readIndex(0),
+    underruns(0)
+{
+    //a power of two lets the indices run freely and wrap with a mask
+    this->capacity = 1;
+    while (this->capacity < capacity)
+        this->capacity <<= 1;
+
+    samples = new INT16[this->capacity];
+    memset(samples, 0, this->capacity * sizeof(INT16));
+}
+
+AudioRingBuffer::~AudioRingBuffer()
+{
+    delete[] samples;
+}
+
+UINT32 AudioRingBuffer::getAvailable()
+{
+    return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire);
+}
+
+UINT32 AudioRingBuffer::write(const INT16* in, UINT32 count)
+{
+    UINT32 nextWrite = writeIndex.load(std::memory_order_relaxed);
+    UINT32 space = capacity - (nextWrite - readIndex.load(std::memory_order_acquire));
+    if (count > space) {
+        overruns.fetch_add(1, std::memory_order_relaxed);
+        count = space;
+    }
+
+    //copy in up to two pieces, either side of the end of the ring
+    UINT32 start = nextWrite & (capacity-1);
+    UINT32 first = (count < capacity - start ? count : capacity - start);
+    memcpy(samples + start, in, first * sizeof(INT16));
+    memcpy(samples, in + first, (count - first) * sizeof(INT16));
+
+    writeIndex.store(nextWrite + count, std::memory_order_release);
+    return count;
+}
+
+UINT32 AudioRingBuffer::read(INT16* out, UINT32 count)
+{
+    UINT32 nextRead = readIndex.load(std::memory_order_relaxed);
+    UINT32 available = writeIndex.load(std::memory_order_acquire) - nextRead;
+    UINT32 toRead = count;
+    if (toRead > available) {
+        underruns.fetch_add(1, std::memory_order_relaxed);
+        toRead = available;
+    }
+
+    UINT32 start = nextRead & (capacity-1);
+    UINT32 first = (toRead < capacity - start ? toRead : capacity - start);
+    memcpy(out, samples + start, first * sizeof(INT16));
+    memcpy(out + first, samples, (toRead - first) * sizeof(INT16));
+    memset(out + toRead, 0, (count - toRead) * sizeof(INT16));
+
+    readIndex.store(nextRead + toRead, std::memory_order_release);
+    return toRead;
+}
@@ -0,0 +1,67 @@
+
+#ifndef AUDIORINGBUFFER_H
+#define AUDIORINGBUFFER_H
+
+#include <atomic>
+#include "core/types.h"
+
+//the indices are kept this far apart so that the two threads never write
+//to the same cache line
+#define AUDIO_CACHE_LINE_SIZE   64
+
+/**
+ * A wait-free ring of output samples from the thread that flushes the
+ * mixer (the only writer) to the audio device thread (the only reader).
+ * Neither side ever blocks: samples that do not fit are dropped and a
+ * short read is padded with silence, and each of those is counted.
+ */
+class AudioRingBuffer
+{
+
+    public:
+        /**
+         * @param capacity the number of samples to hold, rounded up to a
+         *                 power of two
+         */
+        AudioRingBuffer(UINT32 capacity);
+        ~AudioRingBuffer();
+
+        /**
+         * Called by the writer.
+         *
+         * @return the number of samples written, which is less than count
+         *         (an overrun) if the ring did not have room for them all
+         */
+        UINT32 write(const INT16* samples, UINT32 count);
+
+        /**
+         * Called by the reader.  If fewer than count samples are available
+         * (an underrun) the rest of the output is filled with silence.
+         *
+         * @return the number of samples that were read from the ring
+         */
+        UINT32 read(INT16* samples, UINT32 count);
+
+        UINT32 getCapacity() { return capacity; }
+        UINT32 getAvailable();
+        UINT32 getOverrunCount() { return overruns.load(std::memory_order_relaxed); }
+        UINT32 getUnderrunCount() { return underruns.load(std::memory_order_relaxed); }
+
+    private:
+        INT16*  samples;
+        UINT32  capacity;
+        UINT8   sharedPad[AUDIO_CACHE_LINE_SIZE];
+
+        //owned by the writer
+        std::atomic<UINT32> writeIndex;
+        std::atomic<UINT32> overruns;
+        UINT8               writerPad[AUDIO_CACHE_LINE_SIZE];
+
+        //owned by the reader
+        std::atomic<UINT32> readIndex;
+        std::atomic<UINT32> underruns;
+        UINT8               readerPad[AUDIO_CACHE_LINE_SIZE];
+
+};
+
+#endif
@@ -1,30 +1,233 @@
 
+#include <string.h>
 #include "Pokey.h"
+#include "core/cpu/ProcessorBus.h"
+
+//the clock dividers of the 64 kHz and 15 kHz base clocks
+#define BASE_CLOCK_64KHZ    28
+#define BASE_CLOCK_15KHZ    114
+
+//the amplitude of one step of channel volume, so that all four channels at
+//full volume stay within a 16-bit sample
+#define VOLUME_STEP         0x200
+
+UINT8 Pokey::POLY4[15];
+UINT8 Pokey::POLY5[31];
+UINT8 Pokey::POLY9[511];
+UINT8 Pokey::POLY17[131071];
+
+void Pokey::initPolynomialTables()
+{
+    static BOOL initialized = FALSE;
+    if (initialized)
+        return;
+
+    //each counter is a shift register fed back through an xnor of two of its
+    //bits, which runs through every state but all ones from a start of zero
+    UINT8* tables[4] = { POLY4, POLY5, POLY9, POLY17 };
+    const UINT32 sizes[4] = { 4, 5, 9, 17 };
+    const UINT32 taps[4] = { 1, 2, 4, 3 };
+    for (UINT32 i = 0; i < 4; i++) {
+        UINT32 length = (1 << sizes[i]) - 1;
+        UINT32 lfsr = 0;
+        for (UINT32 j = 0; j < length; j++) {
+            tables[i][j] = (UINT8)(lfsr & 1);
+            UINT32 feedback = ~(lfsr ^ (lfsr >> taps[i])) & 1;
+            lfsr = (lfsr >> 1) | (feedback << (sizes[i]-1));
+        }
+    }
+
+    initialized = TRUE;
+}
 
 void Pokey::resetProcessor()
 {
-    AUDF1 = 0;
-    AUDC1 = 0;
-    AUDF2 = 0;
-    AUDC2 = 0;
-    AUDF3 = 0;
-    AUDC3 = 0;
-    AUDF4 = 0;
-    AUDC4 = 0;
+    memset(AUDF, 0, sizeof(AUDF));
+    memset(AUDC, 0, sizeof(AUDC));
     AUDCTL = 0;
     STIMER = 0;
     SKRES = 0;
     POTGO = 0;
     SEROUT = 0;
     IRQEN = 0;
-    IRQST = 0;
+    IRQST = 0xFF;
     SKCTLS = 0;
     KBCODE = 0;
     KBCODE_LATCH = 0;
 
+    memset(outputs, 0, sizeof(outputs));
+    memset(highPass, 0, sizeof(highPass));
+    memset(counters, 0, sizeof(counters));
+    clock = 0;
+    sampleAccumulator = 0;
+    sampleClocksLeft = POKEY_CLOCKS_PER_SAMPLE;
+    updatePeriods();
+
     pinOut[POKEY_PIN_OUT_IRQ]->isHigh = TRUE;
 }
 
+PokeyState Pokey::getState()
+{
+    PokeyState state = {0};
+
+    state.clock = this->clock;
+    memcpy(state.periods, this->periods, sizeof(this->periods));
+    memcpy(state.counters, this->counters, sizeof(this->counters));
+    state.sampleAccumulator = this->sampleAccumulator;
+    state.sampleClocksLeft = this->sampleClocksLeft;
+    memcpy(state.AUDF, this->AUDF, sizeof(this->AUDF));
+    memcpy(state.AUDC, this->AUDC, sizeof(this->AUDC));
+    memcpy(state.outputs, this->outputs, sizeof(this->outputs));
+    memcpy(state.highPass, this->highPass, sizeof(this->highPass));
+    state.AUDCTL = this->AUDCTL;
+    state.STIMER = this->STIMER;
+    state.SKRES = this->SKRES;
+    state.POTGO = this->POTGO;
+    state.SEROUT = this->SEROUT;
+    state.IRQEN = this->IRQEN;
+    state.IRQST = this->IRQST;
+    state.SKCTLS = this->SKCTLS;
+    state.KBCODE = this->KBCODE;
+    state.KBCODE_LATCH = this->KBCODE_LATCH;
+
+    return state;
+}
+
+void Pokey::setState(PokeyState state)
+{
+    this->clock = state.clock;
+    memcpy(this->periods, state.periods, sizeof(this->periods));
+    memcpy(this->counters, state.counters, sizeof(this->counters));
+    this->sampleAccumulator = state.sampleAccumulator;
+    this->sampleClocksLeft = state.sampleClocksLeft;
+    memcpy(this->AUDF, state.AUDF, sizeof(this->AUDF));
+    memcpy(this->AUDC, state.AUDC, sizeof(this->AUDC));
+    memcpy(this->outputs, state.outputs, sizeof(this->outputs));
+    memcpy(this->highPass, state.highPass, sizeof(this->highPass));
+    this->AUDCTL = state.AUDCTL;
+    this->STIMER = state.STIMER;
+    this->SKRES = state.SKRES;
+    this->POTGO = state.POTGO;
+    this->SEROUT = state.SEROUT;
+    this->IRQEN = state.IRQEN;
+    this->IRQST = state.IRQST;
+    this->SKCTLS = state.SKCTLS;
+    this->KBCODE = state.KBCODE;
+    this->KBCODE_LATCH = state.KBCODE_LATCH;
+}
+
+void Pokey::updatePeriods()
+{
+    INT32 base = (AUDCTL & 0x01) ? BASE_CLOCK_15KHZ : BASE_CLOCK_64KHZ;
+
+    //channels 1 and 3 can instead count the cpu clock directly, which takes
+    //a few extra clocks to reload
+    periods[0] = (AUDCTL & 0x40) ? AUDF[0] + 4 : (AUDF[0] + 1) * base;
+    periods[2] = (AUDCTL & 0x20) ? AUDF[2] + 4 : (AUDF[2] + 1) * base;
+
+    //linked channels count through both dividers and sound on the high one
+    if (AUDCTL & 0x10) {
+        INT32 divider = (AUDF[1] << 8) | AUDF[0];
+        periods[1] = (AUDCTL & 0x40) ? divider + 7 : (divider + 1) * base;
+        periods[0] = 0;
+    }
+    else
+        periods[1] = (AUDF[1] + 1) * base;
+
+    if (AUDCTL & 0x08) {
+        INT32 divider = (AUDF[3] << 8) | AUDF[2];
+        periods[3] = (AUDCTL & 0x20) ? divider + 7 : (divider + 1) * base;
+        periods[2] = 0;
+    }
+    else
+        periods[3] = (AUDF[3] + 1) * base;
+
+    //a channel coming out of a linked pair starts a fresh count
+    for (INT32 i = 0; i < 4; i++) {
+        if (counters[i] <= 0)
+            counters[i] = periods[i];
+    }
+}
+
+void Pokey::restartTimers()
+{
+    for (INT32 i = 0; i < 4; i++)
+        counters[i] = periods[i];
+}
+
+void Pokey::clockChannel(INT32 channel)
+{
+    //the 5-bit counter, unless bypassed, gates which underflows change the
+    //output; the output then toggles or samples the selected noise
+    UINT8 audc = AUDC[channel];
+    if ((audc & 0x80) || POLY5[clock % 31]) {
+        if (audc & 0x20)
+            outputs[channel] ^= 1;
+        else if (audc & 0x40)
+            outputs[channel] = POLY4[clock % 15];
+        else if (AUDCTL & 0x80)
+            outputs[channel] = POLY9[clock % 511];
+        else
+            outputs[channel] = POLY17[clock % 131071];
+    }
+
+    //channels 3 and 4 clock the high-pass flip-flops of channels 1 and 2
+    if (channel == 2)
+        highPass[0] = outputs[0];
+    else if (channel == 3)
+        highPass[1] = outputs[1];
+
+    //channels 1, 2 and 4 double as the timers; the low half of a linked
+    //pair never counts out on its own, so a joined pair raises only the
+    //interrupt of its high channel
+    UINT8 timerBit = (channel == 0 ? 0x01 : (channel == 1 ? 0x02 : (channel == 3 ? 0x04 : 0)));
+    if (IRQEN & timerBit) {
+        IRQST &= ~timerBit;
+        pinOut[POKEY_PIN_OUT_IRQ]->isHigh = FALSE;
+    }
+}
+
+INT32 Pokey::getOutput()
+{
+    INT32 output = 0;
+    for (INT32 i = 0; i < 4; i++) {
+        //the low half of a linked pair is silent
+        if (periods[i] == 0)
+            continue;
+
+        UINT8 audc = AUDC[i];
+        UINT8 bit = outputs[i];
+        if (i == 0 && (AUDCTL & 0x04))
+            bit ^= highPass[0];
+        else if (i == 1 && (AUDCTL & 0x02))
+            bit ^= highPass[1];
+
+        if ((audc & 0x10) || bit)
+            output += (audc & 0x0F);
+    }
+    return output * VOLUME_STEP;
+}
+
+UINT8 Pokey::getRandom()
+{
+    //the cpu reads the register from within a slice that the counters may
+    //already have run past, or not yet reached, so find where it falls
+    INT64 readClock = (INT64)clock;
+    if (processorBus != NULL)
+        readClock -= processorBus->getTicksAhead(this);
+    if (readClock < 0)
+        readClock = 0;
+
+    //the register shows eight successive bits of the 9 or 17-bit counter
+    UINT8 random = 0;
+    for (UINT32 i = 0; i < 8; i++) {
+        UINT64 position = (UINT64)readClock + i;
+        UINT8 bit = (AUDCTL & 0x80) ? POLY9[position % 511] : POLY17[position % 131071];
+        random = (UINT8)((random << 1) | bit);
+    }
+    return random;
+}
+
 INT32 Pokey::tick(INT32 minimum)
 {
     //check the keypad keys
@@ -38,6 +241,42 @@ INT32 Pokey::tick(INT32 minimum)
         KBCODE = newCode;
     }
 
-    audioOutputLine->playSample(0);
+    //step from one divider underflow or sample boundary to the next, since
+    //the output cannot change in between
+    INT32 output = getOutput();
+    INT32 remaining = minimum;
+    while (remaining > 0) {
+        INT32 step = (sampleClocksLeft < remaining ? sampleClocksLeft : remaining);
+        for (INT32 i = 0; i < 4; i++) {
+            if (periods[i] != 0 && counters[i] < step)
+                step = counters[i];
+        }
+
+        sampleAccumulator += output * step;
+        sampleClocksLeft -= step;
+        remaining -= step;
+        clock += step;
+
+        BOOL changed = FALSE;
+        for (INT32 i = 0; i < 4; i++) {
+            if (periods[i] == 0)
+                continue;
+            counters[i] -= step;
+            if (counters[i] <= 0) {
+                counters[i] += periods[i];
+                clockChannel(i);
+                changed = TRUE;
+            }
+        }
+        if (changed)
+            output = getOutput();
+
+        if (sampleClocksLeft == 0) {
+            audioOutputLine->playSample((INT16)(sampleAccumulator / POKEY_CLOCKS_PER_SAMPLE));
+            sampleAccumulator = 0;
+            sampleClocksLeft = POKEY_CLOCKS_PER_SAMPLE;
+        }
+    }
+
     return minimum;
-}
\ No newline at end of file
+}
@@ -9,6 +9,37 @@
 
 #define POKEY_PIN_OUT_IRQ   0
 
+#define POKEY_CLOCKS_PER_SAMPLE 28
+
+TYPEDEF_STRUCT_PACK( _PokeyState
+{
+    UINT64 clock;
+    INT32  periods[4];
+    INT32  counters[4];
+    INT32  sampleAccumulator;
+    INT32  sampleClocksLeft;
+    UINT8  AUDF[4];
+    UINT8  AUDC[4];
+    UINT8  outputs[4];
+    UINT8  highPass[2];
+    UINT8  AUDCTL;
+    UINT8  STIMER;
+    UINT8  SKRES;
+    UINT8  POTGO;
+    UINT8  SEROUT;
+    UINT8  IRQEN;
+    UINT8  IRQST;
+    UINT8  SKCTLS;
+    UINT8  KBCODE;
+    UINT8  KBCODE_LATCH;
+} PokeyState; )
+
+/**
+ * The Atari POKEY, which scans the keypads and generates the sound of four
+ * channels. Each channel divides down one of the clocks and, on each
+ * underflow, updates its output from a square wave or from one of the
+ * polynomial noise counters.
+ */
 class Pokey : public Processor, public AudioProducer
 {
     friend class Pokey_Registers;
@@ -22,27 +53,42 @@ class Pokey : public Processor, public AudioProducer
               rightInput(right)
         {
             registers.init(this);
+            initPolynomialTables();
         }
 
         void resetProcessor();
         INT32 getClockSpeed() { return 1792080; }
-        INT32 getClocksPerSample() { return 1; }
-        INT32 getSampleRate() { return getClockSpeed(); }
+        INT32 getClocksPerSample() { return POKEY_CLOCKS_PER_SAMPLE; }
+        INT32 getSampleRate() { return getClockSpeed() / POKEY_CLOCKS_PER_SAMPLE; }
 
         INT32 tick(INT32 minimum);
 
+        PokeyState getState();
+        void setState(PokeyState state);
+
     private:
+        /**
+         * The output bits of the 4, 5, 9 and 17-bit polynomial counters over
+         * one full period each. The counters run at the full clock rate, so
+         * each is indexed by the clock count modulo its length.
+         */
+        static UINT8 POLY4[15];
+        static UINT8 POLY5[31];
+        static UINT8 POLY9[511];
+        static UINT8 POLY17[131071];
+        static void initPolynomialTables();
+
+        void updatePeriods();
+        void restartTimers();
+        void clockChannel(INT32 channel);
+        INT32 getOutput();
+        UINT8 getRandom();
+
         Pokey_Input* leftInput;
         Pokey_Input* rightInput;
 
-        UINT8 AUDF1;
-        UINT8 AUDC1;
-        UINT8 AUDF2;
-        UINT8 AUDC2;
-        UINT8 AUDF3;
-        UINT8 AUDC3;
-        UINT8 AUDF4;
-        UINT8 AUDC4;
+        UINT8 AUDF[4];
+        UINT8 AUDC[4];
         UINT8 AUDCTL;
         UINT8 STIMER;
         UINT8 SKRES;
@@ -54,6 +100,25 @@ class Pokey : public Processor, public AudioProducer
         
         UINT8 KBCODE;
         UINT8 KBCODE_LATCH;
+
+        //the clocks between underflows of each channel, or 0 while the
+        //channel is the low half of a 16-bit pair
+        INT32 periods[4];
+
+        //the clocks left until each channel underflows
+        INT32 counters[4];
+
+        //the output flip-flop of each channel, and the flip-flops latching
+        //channels 1 and 2 for the high-pass filters clocked by 3 and 4
+        UINT8 outputs[4];
+        UINT8 highPass[2];
+
+        //the clocks run since reset, which position the polynomial counters
+        UINT64 clock;
+
+        //the output summed over the clocks of the sample being built
+        INT32 sampleAccumulator;
+        INT32 sampleClocksLeft;
 };
 
 #endif
@@ -21,34 +21,40 @@ void Pokey_Registers::poke(UINT16 addr, UINT16 val)
     switch (addr & 0x0F) 
     {
         case 0x0:  //AUDF1
-            pokey->AUDF1 = (UINT8)val;
+            pokey->AUDF[0] = (UINT8)val;
+            pokey->updatePeriods();
             break;
         case 0x1:  //AUDC1
-            pokey->AUDC1 = (UINT8)val;
+            pokey->AUDC[0] = (UINT8)val;
             break;
         case 0x2:  //AUDF2
-            pokey->AUDF2 = (UINT8)val;
+            pokey->AUDF[1] = (UINT8)val;
+            pokey->updatePeriods();
             break;
         case 0x3:  //AUDC2
-            pokey->AUDC2 = (UINT8)val;
+            pokey->AUDC[1] = (UINT8)val;
             break;
         case 0x4:  //AUDF3
-            pokey->AUDF3 = (UINT8)val;
+            pokey->AUDF[2] = (UINT8)val;
+            pokey->updatePeriods();
             break;
         case 0x5:  //AUDC3
-            pokey->AUDC3 = (UINT8)val;
+            pokey->AUDC[2] = (UINT8)val;
             break;
         case 0x6:  //AUDF4
-            pokey->AUDF4 = (UINT8)val;
+            pokey->AUDF[3] = (UINT8)val;
+            pokey->updatePeriods();
             break;
         case 0x7:  //AUDC4
-            pokey->AUDC4 = (UINT8)val;
+            pokey->AUDC[3] = (UINT8)val;
             break;
         case 0x8:  //AUDCTL
             pokey->AUDCTL = (UINT8)val;
+            pokey->updatePeriods();
             break;
         case 0x9:  //STIMER
             pokey->STIMER = (UINT8)val;
+            pokey->restartTimers();
             break;
         case 0xA:  //SKRES
             pokey->SKRES = (UINT8)val;
@@ -94,7 +100,7 @@ UINT16 Pokey_Registers::peek(UINT16 addr)
         case 0x9:  //KBCODE
             return pokey->KBCODE_LATCH<<1;
         case 0xA:  //RANDOM
-            break;
+            return pokey->getRandom();
         case 0xD:  //SERIN
             break;
         case 0xE:  //IRQST
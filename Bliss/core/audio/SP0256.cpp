@@ -46,7 +46,9 @@ const INT32 SP0256::qtbl[256] = {
 
 SP0256::SP0256()
     : Processor("SP0256"),
-      ivoiceROM("Intellivoice ROM", "ivoice.bin", 0, 1, 0x800, 0x1000, TRUE)
+      ivoiceROM("Intellivoice ROM", "ivoice.bin", 0, 1, 0x800, 0x1000, TRUE),
+      speechROM(&ivoiceROM),
+      synthesizer(NULL)
 {
     registers.init(this);
 }
@@ -84,13 +86,26 @@ void SP0256::resetProcessor()
         y[i][0] = 0;
         y[i][1] = 0;
     }
+    updateCoefficients();
 }
 
 INT32 SP0256::tick(INT32 minimum)
+{
+    if (eventQueue == NULL)
+        return run<TRUE>(minimum);
+
+    //the audio thread does the synthesis, but LRQ and the FIFO must still
+    //be kept up to date here for the CPU to read
+    logEvent(AUDIO_EVENT_TICK, 0, minimum);
+    return run<FALSE>(minimum);
+}
+
+template <BOOL SYNTHESIZE>
+INT32 SP0256::run(INT32 minimum)
 {
     if (idle) {
-        for (int i = 0; i < minimum; i++)
-            audioOutputLine->playSample(0);
+        if (SYNTHESIZE)
+            audioOutputLine->playRun(0, minimum);
         return minimum;
     }
 
@@ -106,11 +121,16 @@ INT32 SP0256::tick(INT32 minimum)
         }
 
         //if the speaking filters are empty, fill 'em up
-        while (!idle && repeat == 0) {
-            INT32 repeatBefore = repeatPrefix;
-            decode();
-            if (repeatBefore != 0)
-                repeatPrefix = 0;
+        if (!idle && repeat == 0) {
+            do {
+                INT32 repeatBefore = repeatPrefix;
+                decode();
+                if (repeatBefore != 0)
+                    repeatPrefix = 0;
+            } while (!idle && repeat == 0);
+
+            if (SYNTHESIZE)
+                updateCoefficients();
         }
 
         INT32 sample = 0;
@@ -118,26 +138,31 @@ INT32 SP0256::tick(INT32 minimum)
             if (periodCounter == 0) {
                 periodCounter = 64;
                 repeat--;
-                for (UINT8 j = 0; j < 6; j++)
-                    y[j][0] = y[j][1] = 0;
+                if (SYNTHESIZE) {
+                    for (UINT8 j = 0; j < 6; j++)
+                        y[j][0] = y[j][1] = 0;
+                }
             }
             else
                 periodCounter--;
 
-            sample = ((amplitude & 0x1F) << ((amplitude & 0xE0) >> 5));
-            BOOL noise = ((random & 1) != 0);
-            random = (random >> 1) ^ (noise ? 0x14000 : 0);
-            if (!noise)
-                sample = -sample;
+            if (SYNTHESIZE) {
+                sample = ((amplitude & 0x1F) << ((amplitude & 0xE0) >> 5));
+                BOOL noise = ((random & 1) != 0);
+                random = (random >> 1) ^ (noise ? 0x14000 : 0);
+                if (!noise)
+                    sample = -sample;
+            }
         }
         else {
             if (periodCounter == 0) {
                 periodCounter = period;
                 repeat--;
-                sample = ((amplitude & 0x1F) << ((amplitude & 0xE0) >> 5));
-                for (INT32 j = 0; j < 6; j++)
-                    y[j][0] = y[j][1] = 0;
-
+                if (SYNTHESIZE) {
+                    sample = ((amplitude & 0x1F) << ((amplitude & 0xE0) >> 5));
+                    for (INT32 j = 0; j < 6; j++)
+                        y[j][0] = y[j][1] = 0;
+                }
             }
             else
                 periodCounter--;
@@ -146,18 +171,27 @@ INT32 SP0256::tick(INT32 minimum)
         period = ((period | 0x10000) + periodInterpolation) & 0xFFFF;
         amplitude = ((amplitude | 0x10000) + amplitudeInterpolation) & 0xFFFF;
 
-        for (INT32 i = 0; i < 6; i++) {
-            sample += ((qtbl[0x80+b[i]]*y[i][1]) >> 9);
-            sample += ((qtbl[0x80+f[i]]*y[i][0]) >> 8);
-            y[i][1] = y[i][0];
-            y[i][0] = sample;
-        }
+        if (SYNTHESIZE) {
+            //the feedback terms of the stages depend only on the outputs
+            //of the previous sample, so work them all out before running
+            //the sample through the chain
+            INT32 terms[6];
+            for (INT32 i = 0; i < 6; i++) {
+                terms[i] = ((bCoefficients[i]*y[i][1]) >> 9) +
+                        ((fCoefficients[i]*y[i][0]) >> 8);
+            }
+            for (INT32 i = 0; i < 6; i++) {
+                sample += terms[i];
+                y[i][1] = y[i][0];
+                y[i][0] = sample;
+            }
 
-        //clamp the sample to a 12-bit range
-        if (sample > 2047) sample = 2047;
-        if (sample < -2048) sample = -2048;
+            //clamp the sample to a 12-bit range
+            if (sample > 2047) sample = 2047;
+            if (sample < -2048) sample = -2048;
 
-        audioOutputLine->playSample((INT16)(sample << 4));
+            audioOutputLine->playSample((INT16)(sample << 4));
+        }
 
         totalTicks++;
 
@@ -165,6 +199,45 @@ INT32 SP0256::tick(INT32 minimum)
     return totalTicks;
 }
 
+/**
+ * Looks up the filter coefficients for the current frame.  They only change
+ * when the microsequencer decodes a new frame, so this saves two table
+ * lookups per filter stage on every sample.
+ */
+void SP0256::updateCoefficients()
+{
+    for (INT32 i = 0; i < 6; i++) {
+        bCoefficients[i] = qtbl[0x80+b[i]];
+        fCoefficients[i] = qtbl[0x80+f[i]];
+    }
+}
+
+BOOL SP0256::deferSynthesis()
+{
+    //the copy on the audio thread reads its speech from this ROM, since
+    //only this one has been loaded
+    synthesizer = new SP0256();
+    synthesizer->speechROM = &ivoiceROM;
+    synthesizer->setState(getState());
+    synthesizer->audioOutputLine = audioOutputLine;
+    return TRUE;
+}
+
+void SP0256::replayEvent(const AudioEvent* event)
+{
+    if (event->type == AUDIO_EVENT_TICK)
+        synthesizer->run<TRUE>(event->value);
+    else
+        synthesizer->registers.poke(event->location, (UINT16)event->value);
+}
+
+void SP0256::resumeSynthesis()
+{
+    setState(synthesizer->getState());
+    delete synthesizer;
+    synthesizer = NULL;
+}
+
 INT8 SP0256::readDelta(INT32 numBits) {
     INT32 value = readBits(numBits);
     if ((value & (1 << (numBits - 1))) != 0)
@@ -179,7 +252,7 @@ INT32 SP0256::readBits(INT32 numBits) {
 INT32 SP0256::readBits(INT32 numBits, BOOL reverseOrder) {
     while (bitsLeft < numBits) {
         if (pc < 0x1800) {
-            currentBits |= (ivoiceROM.peek((UINT16)pc) << bitsLeft);
+            currentBits |= (speechROM->peek((UINT16)pc) << bitsLeft);
             bitsLeft += 8;
             pc = (pc+1) & 0xFFFF;
         }
@@ -880,7 +953,7 @@ SP0256State SP0256::getState()
 	state.amplitude = this->amplitude;
 	memcpy(state.b, this->b, sizeof(this->b));
 	memcpy(state.f, this->f, sizeof(this->f));
-	memcpy(state.y, this->y, sizeof(this->f));
+	memcpy(state.y, this->y, sizeof(this->y));
 	state.periodInterpolation = this->periodInterpolation;
 	state.amplitudeInterpolation = this->amplitudeInterpolation;
 
@@ -914,9 +987,11 @@ void SP0256::setState(SP0256State state)
 	this->amplitude = state.amplitude;
 	memcpy(this->b, state.b, sizeof(this->b));
 	memcpy(this->f, state.f, sizeof(this->f));
-	memcpy(this->y, state.y, sizeof(this->f));
+	memcpy(this->y, state.y, sizeof(this->y));
 	this->periodInterpolation = state.periodInterpolation;
 	this->amplitudeInterpolation = state.amplitudeInterpolation;
 
 	this->random = state.random;
+
+	updateCoefficients();
 }
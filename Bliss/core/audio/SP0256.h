@@ -58,7 +58,15 @@ class SP0256 : public Processor, public AudioProducer
         SP0256_Registers registers;
         ROM        ivoiceROM;
 
+    protected:
+        BOOL deferSynthesis();
+        void replayEvent(const AudioEvent* event);
+        void resumeSynthesis();
+
     private:
+        template <BOOL SYNTHESIZE>
+        INT32 run(INT32 minimum);
+        void updateCoefficients();
         INT8 readDelta(INT32 numBits);
         INT32 readBits(INT32 numBits);
         INT32 readBits(INT32 numBits, BOOL reverseOrder);
@@ -116,9 +124,18 @@ class SP0256 : public Processor, public AudioProducer
         INT8  periodInterpolation;
         INT8  amplitudeInterpolation;
 
+        //filter coefficients looked up from b and f
+        INT32 bCoefficients[6];
+        INT32 fCoefficients[6];
+
         //random number generator
         INT32                random;
 
+        //the ROM the speech is read from, and the copy of this chip that
+        //synthesises on the audio thread while synthesis is deferred
+        ROM*    speechROM;
+        SP0256* synthesizer;
+
         //coefficient table
         static const INT32 qtbl[256];
 };
@@ -37,6 +37,9 @@ void SP0256_Registers::poke(UINT16 location, UINT16 value)
             }
             break;
     }
+
+    if (ms->eventQueue != NULL)
+        ms->logEvent(AUDIO_EVENT_WRITE, location, value);
 }
 
 UINT16 SP0256_Registers::peek(UINT16 location) {
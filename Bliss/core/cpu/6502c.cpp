@@ -1,5 +1,8 @@
 
 #include <string.h>
+#if defined(DEBUG)
+#include <assert.h>
+#endif
 #include "6502c.h"
 #include "core/types.h"
 #include "core/memory/MemoryBus.h"
@@ -7,6 +10,8 @@
 const UINT16 _6502c::resetVector = 0xFFFC;
 const UINT16 _6502c::irqVector = 0xFFFE;
 const UINT16 _6502c::nmiVector = 0xFFFA;
+UINT16 _6502c::DECIMAL_ADC[2][256][256];
+UINT16 _6502c::DECIMAL_SBC[2][256][256];
 
 #define PEEK(x)          (UINT8)memoryBus->peek(x)
 #define POKE(x, y)       memoryBus->poke(x, (UINT8)y)
@@ -15,19 +20,235 @@ const UINT16 _6502c::nmiVector = 0xFFFA;
 
 _6502c::_6502c(MemoryBus* mb)
 : Processor("6502c"),
-  memoryBus(mb)
-{}
+  memoryBus(mb),
+  directPages(NULL),
+  usedCycles(0)
+{
+    memset(decodedPages, 0, sizeof(decodedPages));
+    initDecimalTables();
+}
+
+_6502c::~_6502c()
+{
+    releaseDecodedPages();
+}
+
+#if defined(DEBUG)
+//the decimal mode arithmetic as it was computed before the tables, kept to
+//check every table entry against; results are packed as in the tables
+static UINT16 decimalADC(UINT8 ac, UINT8 x, BOOL c)
+{
+    UINT16 tmp = (ac & 0x0F) + (x & 0x0F) + (c ? 1 : 0);
+    if (tmp >= 10)
+        tmp = (tmp - 10) | 0x10;
+    tmp += (ac & 0xF0) + (x & 0xF0);
+
+    BOOL Z = (ac + x + (c ? 1 : 0)) == 0;
+    BOOL N = !!(tmp & 0x80);
+    BOOL V = (((ac ^ x) & 0x80) & ((ac ^ tmp) & 0x80)) == 0;
+    if (tmp >= 0xA0)
+        tmp += 0x60;
+    BOOL C = !!(tmp & 0x100);
+    return (UINT16)((N << 15) | (V << 14) | (Z << 9) | (C << 8) | (UINT8)tmp);
+}
+
+static UINT16 decimalSBC(UINT8 ac, UINT8 x, BOOL c)
+{
+    UINT16 tmp = (UINT16)(ac - x - (c ? 0 : 1));
+    UINT16 al = (UINT16)((ac & 0x0F) - (x & 0x0F) - (c ? 0 : 1));
+    UINT16 ah = (UINT16)((ac >> 4) - (x >> 4));
+    if (al & 0x10) {
+        al -= 6;
+        ah--;
+    }
+    if (ah & 0x10)
+        ah -= 6;
+    BOOL C = !(tmp & 0x100);
+    BOOL V = (((ac ^ tmp) & 0x80) & ((ac ^ x) & 0x80)) != 0;
+    BOOL N = (tmp & 0x80) != 0;
+    BOOL Z = (tmp == 0);
+    return (UINT16)((N << 15) | (V << 14) | (Z << 9) | (C << 8) |
+            (UINT8)((ah << 4) | (al & 0x0F)));
+}
+#endif
+
+void _6502c::initDecimalTables()
+{
+    static BOOL initialized = FALSE;
+    if (initialized)
+        return;
+
+    for (UINT32 carry = 0; carry < 2; carry++) {
+        for (UINT32 ac = 0; ac < 256; ac++) {
+            for (UINT32 x = 0; x < 256; x++) {
+                //add, adjusting each nibble that passes 9
+                UINT16 tmp = (UINT16)((ac & 0x0F) + (x & 0x0F) + carry);
+                if (tmp >= 10)
+                    tmp = (tmp - 10) | 0x10;
+                tmp += (ac & 0xF0) + (x & 0xF0);
+
+                //the Z flag follows the binary sum; N and V are taken before
+                //the high nibble is adjusted
+                UINT8 flags = 0;
+                if ((ac + x + carry) == 0)
+                    flags |= 0x02;
+                if (tmp & 0x80)
+                    flags |= 0x80;
+                if ((((ac ^ x) & 0x80) & ((ac ^ tmp) & 0x80)) == 0)
+                    flags |= 0x40;
+                if (tmp >= 0xA0)
+                    tmp += 0x60;
+                if (tmp & 0x100)
+                    flags |= 0x01;
+                DECIMAL_ADC[carry][ac][x] = (UINT16)((flags << 8) | (UINT8)tmp);
+
+                //subtract, borrowing 6 from each nibble that wraps; the flags
+                //all follow the binary difference
+                tmp = (UINT16)(ac - x - (carry ? 0 : 1));
+                UINT16 al = (UINT16)((ac & 0x0F) - (x & 0x0F) - (carry ? 0 : 1));
+                UINT16 ah = (UINT16)((ac >> 4) - (x >> 4));
+                if (al & 0x10) {
+                    al -= 6;
+                    ah--;
+                }
+                if (ah & 0x10)
+                    ah -= 6;
+                flags = 0;
+                if (!(tmp & 0x100))
+                    flags |= 0x01;
+                if (((ac ^ tmp) & 0x80) & ((ac ^ x) & 0x80))
+                    flags |= 0x40;
+                if (tmp & 0x80)
+                    flags |= 0x80;
+                if (tmp == 0)
+                    flags |= 0x02;
+                DECIMAL_SBC[carry][ac][x] = (UINT16)((flags << 8) | (UINT8)((ah << 4) | (al & 0x0F)));
+            }
+        }
+    }
+
+#if defined(DEBUG)
+    //every combination of operands and carry must match the arithmetic
+    for (UINT32 carry = 0; carry < 2; carry++) {
+        for (UINT32 ac = 0; ac < 256; ac++) {
+            for (UINT32 x = 0; x < 256; x++) {
+                assert(DECIMAL_ADC[carry][ac][x] == decimalADC((UINT8)ac, (UINT8)x, carry != 0));
+                assert(DECIMAL_SBC[carry][ac][x] == decimalSBC((UINT8)ac, (UINT8)x, carry != 0));
+            }
+        }
+    }
+#endif
+
+    initialized = TRUE;
+}
+
+void _6502c::setDirectPages(WatchedRAM* ram)
+{
+    directPages = (ram != NULL && ram->contains(0x0000) && ram->contains(0x01FF)) ? ram : NULL;
+}
 
 void _6502c::resetProcessor()
 {
     N = V = B = D = I = Z = C = FALSE;
     AC = XR = YR = SP = 0;
+    operand = 0;
     PC = (UINT16)(PEEK(resetVector) | PEEK((UINT16)(resetVector+1)) << 8);
+    decodeReadOnlyPages();
+}
+
+_6502cState _6502c::getState()
+{
+    _6502cState state = {0};
+
+    state.N = this->N;
+    state.V = this->V;
+    state.B = this->B;
+    state.D = this->D;
+    state.I = this->I;
+    state.Z = this->Z;
+    state.C = this->C;
+    state.AC = this->AC;
+    state.XR = this->XR;
+    state.YR = this->YR;
+    state.SP = this->SP;
+    state.PC = this->PC;
+
+    //the levels of the interrupt and dma lines, one bit per pin
+    for (UINT8 i = 0; i <= _6502C_PIN_IN_IRQ; i++) {
+        if (pinIn[i]->isHigh)
+            state.pins |= (1 << i);
+    }
+
+    return state;
+}
+
+void _6502c::setState(_6502cState state)
+{
+    this->N = state.N;
+    this->V = state.V;
+    this->B = state.B;
+    this->D = state.D;
+    this->I = state.I;
+    this->Z = state.Z;
+    this->C = state.C;
+    this->AC = state.AC;
+    this->XR = state.XR;
+    this->YR = state.YR;
+    this->SP = state.SP;
+    this->PC = state.PC;
+
+    for (UINT8 i = 0; i <= _6502C_PIN_IN_IRQ; i++)
+        pinIn[i]->isHigh = !!(state.pins & (1 << i));
+}
+
+void _6502c::decodeReadOnlyPages()
+{
+    //the memory map is fixed from reset on, so every page that is read-only
+    //throughout can have its instructions decoded now rather than each time
+    //they are executed; banked rom is never reported read-only, so a bank
+    //switch cannot leave stale instructions behind
+    releaseDecodedPages();
+    for (UINT32 page = 0; page < 0x100; page++) {
+        UINT32 location = page << 8;
+        UINT32 end = location + 0x100;
+        for (; location < end; location++) {
+            if (!memoryBus->isReadOnly((UINT16)location))
+                break;
+        }
+        if (location < end)
+            continue;
+
+        DecodedInstruction* decoded = new DecodedInstruction[0x100];
+        for (UINT32 i = 0; i < 0x100; i++) {
+            UINT16 pc = (UINT16)((page << 8) | i);
+            UINT8 op = PEEK(pc);
+            UINT8 operandSize = INSTRUCTIONS[op].operandSize;
+            decoded[i].opcode = op;
+            decoded[i].operand = 0;
+            decoded[i].decoded = TRUE;
+            //an operand that spills into writeable memory must be re-read
+            for (UINT8 j = 1; j <= operandSize; j++) {
+                UINT16 next = (UINT16)(pc+j);
+                if (!memoryBus->isReadOnly(next))
+                    decoded[i].decoded = FALSE;
+                decoded[i].operand |= (UINT16)(PEEK(next) << ((j-1) << 3));
+            }
+        }
+        decodedPages[page] = decoded;
+    }
+}
+
+void _6502c::releaseDecodedPages()
+{
+    for (UINT32 page = 0; page < 0x100; page++) {
+        delete[] decodedPages[page];
+        decodedPages[page] = NULL;
+    }
 }
 
 INT32 _6502c::tick(INT32 minimum)
 {
-    INT32 usedCycles = 0;
+    usedCycles = 0;
     do {
 
     if (!pinIn[_6502C_PIN_IN_HALT]->isHigh || !pinIn[_6502C_PIN_IN_READY]->isHigh)
@@ -50,1643 +271,31 @@ INT32 _6502c::tick(INT32 minimum)
         PUSH(SR);
         PC = (UINT16)(PEEK(irqVector) | PEEK((UINT16)(irqVector+1)) << 8);
     }
-    
-    UINT8 op = PEEK(PC);
-    PC++;
-    switch (op) 
-    {
-        default:
-        case 0x00:  //---- 7  BRK
-        {
-            PC += 2;
-            if (!I) {
-                B = TRUE;
-                dPUSH(PC);
-                UINT8 SR = MERGE_SR();
-                PUSH(SR);
-                PC = (UINT16)(PEEK(irqVector) | PEEK((UINT16)(irqVector+1)) << 8);
-            }
-            usedCycles += 7;
-        } break;
-        case 0x01:  //--NZ 6  ORA ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            AC |= PEEK(addr);
-            NZ(AC);
-            usedCycles += 6;
-        } break;
-        case 0x02:  //---- -  KIL
-        {
-            PC--;
-            usedCycles += 1;
-        } break;
-        case 0x03:  //C-NZ 8  SLO ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            SLO(addr);
-            usedCycles += 8;
-        } break;
-        case 0x04:  //---- 3  DOP $44
-        {
-            PC++;
-            usedCycles += 3;
-        } break;
-        case 0x05:  //--NZ 2  ORA $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            AC |= PEEK(addr);
-            NZ(AC);
-            usedCycles += 2;
-        } break;
-        case 0x06:  //C-NZ 5  ASL $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            ASL(addr);
-            usedCycles += 5;
-        } break;
-        case 0x07:  //C-NZ 5  SLO $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            SLO(addr);
-            usedCycles += 5;
-        } break;
-        case 0x08:  //---- 3  PHP
-        {
-            UINT8 sr = MERGE_SR();
-            PUSH(sr);
-            usedCycles += 3;
-        } break;
-        case 0x09:  //--NZ 2  ORA #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            AC |= PEEK(addr);
-            NZ(AC);
-            usedCycles += 2;
-        } break;
-        case 0x0A:  //C-NZ 2  ASL A
-        {
-            C = !!(AC & 0x80);
-            AC <<= 1;
-            NZ(AC);
-            usedCycles += 2;
-        } break;
-        case 0x0B:  //C-NZ 2  AAC #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            AAC(addr);
-            usedCycles += 2;
-        } break;
-        case 0x0C:  //---- 4  TOP $4400
-        {
-            PC += 2;
-            usedCycles += 4;
-        } break;
-        case 0x0D:  //--NZ 4  ORA $4400
-        {
-            UINT16 addr = Absolute();
-            AC |= PEEK(addr);
-            NZ(AC);
-            usedCycles += 4;
-        } break;
-        case 0x0E:  //C-NZ 6  ASL $4400
-        {
-            UINT16 addr = Absolute();
-            ASL(addr);
-            usedCycles += 6;
-        } break;
-        case 0x0F:  //C-NZ 6  SLO $4400
-        {
-            UINT16 addr = Absolute();
-            SLO(addr);
-            usedCycles += 6;
-        } break;
-        case 0x10:  //---- 2|3+ BPL
-        {
-            UINT16 addr = IMMEDIATE();
-            INT8 val = (INT8)PEEK(addr);
-            if (!N) {
-                usedCycles++;
-                //TODO: add an extra cycle if we branch across a page boundary
-                BRANCH(val);
-            }
-            usedCycles += 2;
-        } break;
-        case 0x11:  //--NZ 5+ ORA ($44),Y;
-        {
-            UINT16 addr = INDIRECT_Y();
-            AC |= PEEK(addr);
-            NZ(AC);
-            usedCycles += 5;
-        } break;
-        case 0x12:  //---- 1  KIL
-        {
-            PC--;
-            usedCycles += 1;
-        } break;
-        case 0x13:  //C-NZ 8  SLO ($44),Y
-        {
-            UINT16 addr = INDIRECT_Y();
-            SLO(addr);
-            usedCycles += 8;
-        } break;
-        case 0x14:  //---- 4  DOP
-        {
-            PC++;
-            usedCycles += 4;
-        } break;
-        case 0x15:  //ORA $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            AC |= PEEK(addr);
-            NZ(AC);
-            usedCycles += 3;
-        } break;
-        case 0x16:  //C-NZ 6  ASL $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            ASL(addr);
-            usedCycles += 6;
-        } break;
-        case 0x17:  //C-NZ 6  SLO $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            SLO(addr);
-            usedCycles += 6;
-        } break;
-        case 0x18:  //---- 2  CLC
-        {
-            C = FALSE;
-            usedCycles += 2;
-        } break;
-        case 0x19:  //--NZ 4+ ORA $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            AC |= PEEK(addr);
-            NZ(AC);
-            usedCycles += 4;
-        } break;
-        case 0x1A:  //NOP
-        {
-            usedCycles += 2;
-        } break;
-        case 0x1B:  //C-NZ 7  SLO $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            SLO(addr);
-            usedCycles += 7;
-        } break;
-        case 0x1C:  //TOP
-        {
-            PC += 2;
-            usedCycles += 4;
-        } break;
-        case 0x1D:  //--NZ 4+ ORA $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            AC |= PEEK(addr);
-            NZ(AC);
-            usedCycles += 4;
-        } break;
-        case 0x1E:  //C-NZ 7  ASL $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            ASL(addr);
-            usedCycles += 7;
-        } break;
-        case 0x1F:  //C-NZ 7 SLO $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            SLO(addr);
-            usedCycles += 7;
-        } break;
-        case 0x20:  //---- 6  JSR $4400
-        {
-            UINT16 addr = (UINT16)(PEEK(PC) | (PEEK((UINT16)(PC+1)) << 8));
-            PC += 2;
-            dPUSH(PC);
-            PC = addr;
-            usedCycles += 6;
-        } break;
-        case 0x21:  //AND ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            AC &= PEEK(addr);
-            NZ(AC);
-            usedCycles += 6;
-        } break;
-        case 0x22:  //---- 1  KIL
-        {
-            PC--;
-            usedCycles += 1;
-        } break;
-        case 0x23:  //C-NZ 8  RLA ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            RLA(addr);
-            usedCycles += 8;
-        } break;
-        case 0x24:  //-VNZ 3  BIT $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            BIT(addr);
-            usedCycles += 3;
-        } break;
-        case 0x25:  //--NZ 2  AND $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            AC &= PEEK(addr);
-            NZ(AC);
-            usedCycles += 2;
-        } break;
-        case 0x26:  //C-NZ 5  ROL $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            ROL(addr);
-            usedCycles += 5;
-        } break;
-        case 0x27:  //C-NZ 5  RLA $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            RLA(addr);
-            usedCycles += 5;
-        } break;
-        case 0x28:  //CVNZ 4  PLP
-        {
-            UINT8 sr = POP();
-            SPLIT_SR(sr);
-            usedCycles += 4;
-        } break;
-        case 0x29:  //--NZ 2  AND #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            AC &= PEEK(addr);
-            NZ(AC);
-            usedCycles += 2;
-        } break;
-        case 0x2A:  //C-NZ 2  ROL A
-        {
-            BOOL c = C;
-            C = !!(AC & 0x80);
-            AC = (UINT8)((AC<<1) | (c ? 1 : 0));
-            NZ(AC);
-            usedCycles += 2;
-        } break;
-        case 0x2B:  //AAC #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            AAC(addr);
-            usedCycles += 2;
-        } break;
-        case 0x2C:  //-VNZ 4  BIT $4400
-        {
-            UINT16 addr = Absolute();
-            BIT(addr);
-            usedCycles += 4;
-        } break;
-        case 0x2D:  //--NZ 4  AND $4400
-        {
-            UINT16 addr = Absolute();
-            AC &= PEEK(addr);
-            NZ(AC);
-            usedCycles += 4;
-        } break;
-        case 0x2E:  //C-NZ 6  ROL $4400
-        {
-            UINT16 addr = Absolute();
-            ROL(addr);
-            usedCycles += 6;
-        } break;
-        case 0x2F:  //C-NZ 6  RLA $4400
-        {
-            UINT16 addr = Absolute();
-            RLA(addr);
-            usedCycles += 6;
-        } break;
-        case 0x30:  //BMI
-        {
-            UINT16 addr = IMMEDIATE();
-            INT8 val = (INT8)PEEK(addr);
-            if (N) {
-                usedCycles++;
-                BRANCH(val);
-            }
-            usedCycles += 2;
-        } break;
-        case 0x31:  //--NZ 5+ AND ($44),Y
-        {
-            UINT16 addr = INDIRECT_Y();
-            AC &= PEEK(addr);
-            NZ(AC);
-            usedCycles += 5;
-        } break;
-        case 0x32:  //---- 1  KIL
-        {
-            PC--;
-            usedCycles += 1;
-        } break;
-        case 0x33:  //C-NZ 8  RLA ($44),Y
-        {
-            UINT16 addr = INDIRECT_Y();
-            RLA(addr);
-            usedCycles += 8;
-        } break;
-        case 0x34:  //---- 4  DOP
-        {
-            PC++;
-            usedCycles += 4;
-        } break;
-        case 0x35:  //--NZ 3  AND $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            AC &= PEEK(addr);
-            NZ(AC);
-            usedCycles += 3;
-        } break;
-        case 0x36:  //C-NZ 6  ROL $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            ROL(addr);
-            usedCycles += 6;
-        } break;
-        case 0x37:  //C-NZ 6  RLA $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            RLA(addr);
-            usedCycles += 6;
-        } break;
-        case 0x38:  //C--- 2  SEC
-        {
-            C = TRUE;
-            usedCycles += 2;
-        } break;
-        case 0x39:  //--NZ 4+ AND $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            AC &= PEEK(addr);
-            NZ(AC);
-            usedCycles += 4;
-        } break;
-        case 0x3A:  //NOP
-        {
-            usedCycles += 2;
-        } break;
-        case 0x3B:  //C-NZ 7  RLA $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            RLA(addr);
-            usedCycles += 7;
-        } break;
-        case 0x3C:  //---- 4+ TOP
-        {
-            PC += 2;
-            usedCycles += 4;
-        } break;
-        case 0x3D:  //--NZ 4+ AND $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            AC &= PEEK(addr);
-            NZ(AC);
-            usedCycles += 4;
-        } break;
-        case 0x3E:  //C-NZ 7  ROL $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            ROL(addr);
-            usedCycles += 7;
-        } break;
-        case 0x3F:  //C-NZ 7  RLA $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            RLA(addr);
-            usedCycles += 7;
-        } break;
-        case 0x40:  //CVNZ 6  RTI
-        {
-            UINT8 sr = POP();
-            SPLIT_SR(sr);
-            PC = dPOP();
-            usedCycles += 6;
-        } break;
-        case 0x41:  //--NZ 6  EOR ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            AC ^= PEEK(addr);
-            NZ(AC);
-            usedCycles += 6;
-        } break;
-        case 0x42:  //---- 1  KIL
-        {
-            PC--;
-            usedCycles += 1;
-        } break;
-        case 0x43:  //C-NZ 8  SRE ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            SRE(addr);
-            usedCycles += 8;
-        } break;
-        case 0x44:  //---- 3  DOP
-        {
-            PC++;
-            usedCycles += 3;
-        } break;
-        case 0x45:  //--NZ 3  EOR $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            AC ^= PEEK(addr);
-            NZ(AC);
-            usedCycles += 3;
-        } break;
-        case 0x46:  //C-NZ 5  LSR $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            LSR(addr);
-            usedCycles += 5;
-        } break;
-        case 0x47:  //C-NZ 5  SRE $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            SRE(addr);
-            usedCycles += 5;
-        } break;
-        case 0x48:  //---- 3  PHA
-        {
-            PUSH(AC);
-            usedCycles += 3;
-        } break;
-        case 0x49:  //--NZ 2  EOR #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            AC ^= PEEK(addr);
-            NZ(AC);
-            usedCycles += 2;
-        } break;
-        case 0x4A:  //C-NZ 2  LSR A
-        {
-            C = (AC & 0x01);
-            AC >>= 1;
-            NZ(AC);
-            usedCycles += 2;
-        } break;
-        case 0x4B:  //C-NZ 2  ALR #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            ALR(addr);
-            usedCycles += 2;
-        } break;
-        case 0x4C:  //---- 3  JMP $4400
-        {
-            PC = (UINT16)(PEEK(PC) | (PEEK((UINT16)(PC+1)) << 8));
-            usedCycles += 3;
-        } break;
-        case 0x4D:  //--NZ 4  EOR $4400
-        {
-            UINT16 addr = Absolute();
-            AC ^= PEEK(addr);
-            NZ(AC);
-            usedCycles += 4;
-        } break;
-        case 0x4E:  //C-NZ 6  LSR $4400
-        {
-            UINT16 addr = Absolute();
-            LSR(addr);
-            usedCycles += 6;
-        } break;
-        case 0x4F:  //C-NZ 6  SRE $4400
-        {
-            UINT16 addr = Absolute();
-            SRE(addr);
-            usedCycles += 6;
-        } break;
-        case 0x50:  //---- 2+ BVC
-        {
-            UINT16 addr = IMMEDIATE();
-            INT8 val = (INT8)PEEK(addr);
-            if (!V) {
-                usedCycles++;
-                BRANCH(val);
-            }
-            usedCycles += 2;
-        } break;
-        case 0x51:  //--NZ 5+ EOR ($44),Y
-        {
-            UINT16 addr = INDIRECT_Y();
-            AC ^= PEEK(addr);
-            NZ(AC);
-            usedCycles += 5;
-        } break;
-        case 0x52:  //---- 1  KIL
-        {
-            PC--;
-            usedCycles += 1;
-        } break;
-        case 0x53:  //C-NZ 8  SRE ($44),Y
-        {
-            UINT16 addr = INDIRECT_Y();
-            SRE(addr);
-            usedCycles += 8;
-        } break;
-        case 0x54:  //---- 4  DOP
-        {
-            PC++;
-            usedCycles += 4;
-        } break;
-        case 0x55:  //--NZ 4  EOR $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            AC ^= PEEK(addr);
-            NZ(AC);
-            usedCycles += 4;
-        } break;
-        case 0x56:  //C-NZ 6  LSR $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            LSR(addr);
-            usedCycles += 6;
-        } break;
-        case 0x57:  //C-NZ 6  SRE $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            SRE(addr);
-            usedCycles += 6;
-        } break;
-        case 0x58:  //CLI
-        {
-            I = FALSE;
-            usedCycles += 2;
-        } break;
-        case 0x59:  //--NZ 4+ EOR $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            AC ^= PEEK(addr);
-            NZ(AC);
-            usedCycles += 4;
-        } break;
-        case 0x5A:  //---- 2  NOP
-        {
-            usedCycles += 2;
-        } break;
-        case 0x5B:  //C-NZ 7  SRE $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            SRE(addr);
-            usedCycles += 7;
-        } break;
-        case 0x5C:  //---- 4+ TOP
-        {
-            PC += 2;
-            usedCycles += 4;
-        } break;
-        case 0x5D:  //--NZ 4+ EOR $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            AC ^= PEEK(addr);
-            NZ(AC);
-            usedCycles += 4;
-        } break;
-        case 0x5E:  //C-NZ 7  LSR $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            LSR(addr);
-            usedCycles += 7;
-        } break;
-        case 0x5F:  //C-NZ 7  SRE $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            SRE(addr);
-            usedCycles += 7;
-        } break;
-        case 0x60:  //---- 6  RTS
-        {
-            PC = dPOP();
-            usedCycles += 6;
-        } break;
-        case 0x61:  //CVNZ 6  ADC ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            ADC(addr);
-            usedCycles += 6;
-        } break;
-        case 0x62:  //---- 1  KIL
-        {
-            PC--;
-            usedCycles += 1;
-        } break;
-        case 0x63:  //RRA ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            RRA(addr);
-            usedCycles += 8;
-        } break;
-        case 0x64:  //---- 3  DOP
-        {
-            PC++;
-            usedCycles += 3;
-        } break;
-        case 0x65:  //CVNZ 3  ADC $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            ADC(addr);
-            usedCycles += 3;
-        } break;
-        case 0x66:  //C-NZ 5  ROR $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            ROR(addr);
-            usedCycles += 5;
-        } break;
-        case 0x67:  //RRA $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            RRA(addr);
-            usedCycles += 5;
-        } break;
-        case 0x68:  //--NZ 4  PLA
-        {
-            AC = POP();
-            NZ(AC);
-            usedCycles += 4;
-        } break;
-        case 0x69:  //CVNZ 2  ADC #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            ADC(addr);
-            usedCycles += 2;
-        } break;
-        case 0x6A:  //C-NZ 2  ROR A
-        {
-            UINT8 c = (C ? 0x80 : 0);
-            C = (AC & 0x01);
-            AC = (UINT8)((AC>>1) | c);
-            NZ(AC);
-            usedCycles += 2;
-        } break;
-        case 0x6B:  //ARR #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            UINT8 data = AC & PEEK(addr);
-            if (D) {
-                UINT16 tmp = (data >> 1) | (C ? 0x80 : 0);
-                NZ(tmp);
-                V = !!((tmp ^ data) & 0x40);
-		        if (((data & 0x0F) + (data & 0x01)) > 5)
-			        tmp = (tmp & 0xF0) | ((tmp + 0x6) & 0x0F);
-
-		        if (((data & 0xF0) + (data & 0x10)) > 0x50) {
-			        tmp = (tmp & 0x0F) | ((tmp + 0x60) & 0xF0);
-			        C = TRUE;
-		        }
-		        else
-			        C = FALSE;
-		        AC = (UINT8)tmp;
-            }
-            else {
-                AC = (data >> 1) | (C ? 0x80 : 0);
-                NZ(AC);
-			    C = !!(AC & 0x40);
-			    V = ((AC >> 6) ^ (AC >> 5)) & 1;
-            }
-            usedCycles += 2;
-        } break;
-        case 0x6C:  //---- 5  JMP ($4400)
-        {
-            UINT16 addr = (UINT16)(PEEK(PC) | (PEEK((UINT16)(PC+1)) << 8));
-            PC = (UINT16)(PEEK(addr) | (PEEK((UINT16)(addr+1)) << 8));
-            usedCycles += 5;
-        } break;
-        case 0x6D:  //CVNZ 4  ADC $4400
-        {
-            UINT16 addr = Absolute();
-            ADC(addr);
-            usedCycles += 4;
-        } break;
-        case 0x6E:  //C-NZ 6  ROR $4400
-        {
-            UINT16 addr = Absolute();
-            ROR(addr);
-            usedCycles += 6;
-        } break;
-        case 0x6F:  //RRA $4400
-        {
-            UINT16 addr = Absolute();
-            RRA(addr);
-            usedCycles += 6;
-        } break;
-        case 0x70:  //BVS
-        {
-            UINT16 addr = IMMEDIATE();
-            INT8 val = (INT8)PEEK(addr);
-            if (V) {
-                usedCycles++;
-                BRANCH(val);
-            }
-            usedCycles += 2;
-        } break;
-        case 0x71:  //CVNZ 5+ ADC ($44),Y
-        {
-            UINT16 addr = INDIRECT_Y();
-            ADC(addr);
-            usedCycles += 5;
-        } break;
-        case 0x72:  //---- 1  KIL
-        {
-            PC--;
-            usedCycles += 1;
-        } break;
-        case 0x73:  //CVNZ 8  RRA ($44),Y
-        {
-            UINT16 addr = INDIRECT_Y();
-            RRA(addr);
-            usedCycles += 8;
-        } break;
-        case 0x74:  //---- 4  DOP
-        {
-            PC++;
-            usedCycles += 4;
-        } break;
-        case 0x75:  //CVNZ 4  ADC $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            ADC(addr);
-            usedCycles += 4;
-        } break;
-        case 0x76:  //C-NZ 6  ROR $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            ROR(addr);
-            usedCycles += 6;
-        } break;
-        case 0x77:  //CVNZ 6  RRA $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            RRA(addr);
-            usedCycles += 6;
-        } break;
-        case 0x78:  //SEI
-        {
-            I = TRUE;
-            usedCycles += 2;
-        } break;
-        case 0x79:  //CVNZ 4+ ADC $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            ADC(addr);
-            usedCycles += 4;
-        } break;
-        case 0x7A:  //NOP
-        {
-            usedCycles += 2;
-        } break;
-        case 0x7B:  //CVNZ 7  RRA $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            RRA(addr);
-            usedCycles += 7;
-        } break;
-        case 0x7C:  //---- 4+ TOP
-        {
-            PC += 2;
-            usedCycles += 4;
-        } break;
-        case 0x7D:  //CVNZ 4+ ADC $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            ADC(addr);
-            usedCycles += 4;
-        } break;
-        case 0x7E:  //C-NZ 7  ROR $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            ROR(addr);
-            usedCycles += 7;
-        } break;
-        case 0x7F:  //RRA $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            RRA(addr);
-            usedCycles += 7;
-        } break;
-        case 0x80:  //---- 2 DOP
-        {
-            PC++;
-            usedCycles += 2;
-        } break;
-        case 0x81:  //---- 6  STA ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            POKE(addr, AC);
-            usedCycles += 6;
-        } break;
-        case 0x82:  //---- 2  DOP
-        {
-            PC++;
-            usedCycles += 2;
-        } break;
-        case 0x83:  //---- 6  AAX ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            UINT8 val = (UINT8)(AC & XR);
-            POKE(addr, val);
-            usedCycles += 6;
-        } break;
-        case 0x84:  //---- 3  STY $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            POKE(addr, YR);
-            usedCycles += 3;
-        } break;
-        case 0x85:  //---- 3  STA $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            POKE(addr, AC);
-            usedCycles += 3;
-        } break;
-        case 0x86:  //---- 3  STX $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            POKE(addr, XR);
-            usedCycles += 3;
-        } break;
-        case 0x87:  //---- 3  AAX $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            UINT8 val = (UINT8)(AC & XR);
-            POKE(addr, val);
-            usedCycles += 3;
-        } break;
-        case 0x88:  //--NZ 2  DEY
-        {
-            YR--;
-            NZ(YR);
-            usedCycles += 2;
-        } break;
-        case 0x89:  //---- 2  DOP
-        {
-            PC++;
-            usedCycles += 2;
-        } break;
-        case 0x8A:  //--NZ 2  TXA
-        {
-            AC = XR;
-            NZ(AC);
-            usedCycles += 2;
-        } break;
-        case 0x8B:  //--NZ 2  XAA #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            UINT8 data = PEEK(addr);
-		    UINT8 tmp = AC & XR & data;
-            NZ(tmp);
-		    AC &= XR & (data | 0xEF);
-            usedCycles += 2;
-        } break;
-        case 0x8C:  //---- 4  STY $4400
-        {
-            UINT16 addr = Absolute();
-            POKE(addr, YR);
-            usedCycles += 4;
-        } break;
-        case 0x8D:  //---- 4  STA $4400
-        {
-            UINT16 addr = Absolute();
-            POKE(addr, AC);
-            usedCycles += 4;
-        } break;
-        case 0x8E:  //---- 4  STX $4400
-        {
-            UINT16 addr = Absolute();
-            POKE(addr, XR);
-            usedCycles += 4;
-        } break;
-        case 0x8F:  //---- 4  AAX $4400
-        {
-            UINT16 addr = Absolute();
-            UINT8 val = (UINT8)(AC & XR);
-            POKE(addr, val);
-            usedCycles += 4;
-        } break;
-        case 0x90:  //---- 2+ BCC
-        {
-            UINT16 addr = IMMEDIATE();
-            INT8 val = (INT8)PEEK(addr);
-            if (!C) {
-                usedCycles++;
-                BRANCH(val);
-            }
-            usedCycles += 2;
-        } break;
-        case 0x91:  //---- 6  STA ($44),Y
-        {
-            UINT16 addr = INDIRECT_Y();
-            POKE(addr, AC);
-            usedCycles += 6;
-        } break;
-        case 0x92:  //---- 1  KIL
-        {
-            PC--;
-            usedCycles += 1;
-        } break;
-        case 0x93:  //---- 6  AXA ($44),Y
-        {
-            //TODO: behavior is suspiscious; need to verify
-            UINT16 addr = INDIRECT_Y();
-            UINT8 val = AC & XR & PEEK(addr);
-            POKE(addr, val);
-            usedCycles += 6;
-        } break;
-        case 0x94:  //---- 4  STY ($44,X)
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            POKE(addr, YR);
-            usedCycles += 4;
-        } break;
-        case 0x95:  //---- 4  STA ($44,X)
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            POKE(addr, AC);
-            usedCycles += 4;
-        } break;
-        case 0x96:  //---- 4  STX ($44),Y
-        {
-            UINT16 addr = ZERO_PAGE_Y();
-            POKE(addr, XR);
-            usedCycles += 4;
-        } break;
-        case 0x97:  //---- 4  AAX ($44),Y
-        {
-            UINT16 addr = ZERO_PAGE_Y();
-            UINT8 val = (UINT8)(AC & XR);
-            POKE(addr, val);
-            usedCycles += 4;
-        } break;
-        case 0x98:  //--NZ 2  TYA
-        {
-            AC = YR;
-            NZ(AC);
-            usedCycles += 2;
-        } break;
-        case 0x99:  //---- 5  STA $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            POKE(addr, AC);
-            usedCycles += 5;
-        } break;
-        case 0x9A:  //---- 2  TXS
-        {
-            SP = XR;
-            usedCycles += 2;
-        } break;
-        case 0x9B:  //---- 5  XAS ($44),Y
-        {
-            UINT16 addr = Absolute();
-            SP = (UINT8)(AC & XR);
-            UINT8 val = (UINT8)(SP & ((addr >> 8) + 1));
-            addr = (UINT16)(addr+YR);
-            POKE(addr, val);
-            usedCycles += 5;
-        } break;
-        case 0x9C:  //---- 5  SYA $4400,X
-        {
-            UINT16 addr = Absolute();
-            UINT8 val = (UINT8)(YR & (((addr & 0xFF00) >> 8) + 1));
-            addr = (UINT16)(addr+XR);
-            POKE(addr, val);
-            usedCycles += 5;
-        } break;
-        case 0x9D:  //---- 5  STA $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            POKE(addr, AC);
-            usedCycles += 5;
-        } break;
-        case 0x9E:  //---- 5  SXA $4400,Y
-        {
-            UINT16 addr = Absolute();
-            UINT8 val = (UINT8)(XR & ((addr >> 8) + 1));
-            addr = (UINT16)(addr+YR);
-            POKE(addr, val);
-            usedCycles += 5;
-        } break;
-        case 0x9F:  //---- 5  AXA $4400,Y
-        {
-            UINT16 addr = Absolute();
-		    UINT8 val = (UINT8)(AC & XR & ((addr >> 8) + 1));
-            addr = (UINT16)(addr+YR);
-            POKE(addr, val);
-            usedCycles += 5;
-        } break;
-        case 0xA0:  //--NZ 2  LDY #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            YR = PEEK(addr);
-            NZ(YR);
-            usedCycles += 2;
-        } break;
-        case 0xA1:  //--NZ 6  LDA ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            AC = PEEK(addr);
-            NZ(AC);
-            usedCycles += 6;
-        } break;
-        case 0xA2:  //--NZ 2  LDX #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            XR = PEEK(addr);
-            NZ(XR);
-            usedCycles += 2;
-        } break;
-        case 0xA3:  //--NZ 6  LAX ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            UINT8 val = PEEK(addr);
-            XR = AC = val;
-            NZ(XR);
-            usedCycles += 6;
-        } break;
-        case 0xA4:  //--NZ 3  LDY $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            YR = PEEK(addr);
-            NZ(YR);
-            usedCycles += 3;
-        } break;
-        case 0xA5:  //--NZ 3  LDA $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            AC = PEEK(addr);
-            NZ(AC);
-            usedCycles += 3;
-        } break;
-        case 0xA6:  //--NZ 3  LDX $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            XR = PEEK(addr);
-            NZ(XR);
-            usedCycles += 3;
-        } break;
-        case 0xA7:  //--NZ 3  LAX $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            UINT8 val = PEEK(addr);
-            XR = AC = val;
-            NZ(XR);
-            usedCycles += 3;
-        } break;
-        case 0xA8:  //--NZ 2  TAY
-        {
-            YR = AC;
-            NZ(YR);
-            usedCycles += 2;
-        } break;
-        case 0xA9:  //--NZ 2  LDA #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            AC = PEEK(addr);
-            NZ(AC);
-            usedCycles += 2;
-        } break;
-        case 0xAA:  //--NZ 2  TAX
-        {
-            XR = AC;
-            NZ(XR);
-            usedCycles += 2;
-        } break;
-        case 0xAB:  //--NZ 2  ATX #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            UINT8 val = PEEK(addr);
-            XR = AC &= val;
-            NZ(XR);
-            usedCycles += 2;
-        } break;
-        case 0xAC:  //--NZ 4  LDY $4400
-        {
-            UINT16 addr = Absolute();
-            YR = PEEK(addr);
-            NZ(YR);
-            usedCycles += 4;
-        } break;
-        case 0xAD:  //--NZ 4  LDA $4400
-        {
-            UINT16 addr = Absolute();
-            AC = PEEK(addr);
-            NZ(YR);
-            usedCycles += 4;
-        } break;
-        case 0xAE:  //--NZ 4  LDX $4400
-        {
-            UINT16 addr = Absolute();
-            XR = PEEK(addr);
-            NZ(YR);
-            usedCycles += 4;
-        } break;
-        case 0xAF:  //--NZ 4  LAX $4400
-        {
-            UINT16 addr = Absolute();
-            UINT8 val = PEEK(addr);
-            XR = AC = val;
-            NZ(XR);
-            usedCycles += 4;
-        } break;
-        case 0xB0:  //---- 2+ BCS
-        {
-            UINT16 addr = IMMEDIATE();
-            INT8 val = (INT8)PEEK(addr);
-            if (C) {
-                usedCycles++;
-                BRANCH(val);
-            }
-            usedCycles += 2;
-        } break;
-        case 0xB1:  //--NZ 5+ LDA ($44),Y
-        {
-            UINT16 addr = INDIRECT_Y();
-            AC = PEEK(addr);
-            NZ(AC);
-            usedCycles += 5;
-        } break;
-        case 0xB2:  //---- 1  KIL
-        {
-            PC--;
-            usedCycles += 1;
-        } break;
-        case 0xB3:  //--NZ 5+ LAX ($44),Y
-        {
-            UINT16 addr = INDIRECT_Y();
-            UINT8 val = PEEK(addr);
-            XR = AC = val;
-            NZ(XR);
-            usedCycles += 5;
-        } break;
-        case 0xB4:  //--NZ 4  LDY $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            YR = PEEK(addr);
-            NZ(YR);
-            usedCycles += 4;
-        } break;
-        case 0xB5:  //--NZ 4  LDA $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            AC = PEEK(addr);
-            NZ(AC);
-            usedCycles += 4;
-        } break;
-        case 0xB6:  //--NZ 4  LDX $44,Y
-        {
-            UINT16 addr = ZERO_PAGE_Y();
-            XR = PEEK(addr);
-            NZ(XR);
-            usedCycles += 4;
-        } break;
-        case 0xB7:  //--NZ 4  LAX $44,Y
-        {
-            UINT16 addr = ZERO_PAGE();
-            UINT8 val = PEEK(addr);
-            XR = AC = val;
-            NZ(XR);
-            usedCycles += 4;
-        } break;
-        case 0xB8:  //-V-- 2  CLV
-        {
-            V = FALSE;
-            usedCycles += 2;
-        } break;
-        case 0xB9:  //--NZ 4+ LDA $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            AC = PEEK(addr);
-            NZ(AC);
-            usedCycles += 4;
-        } break;
-        case 0xBA:  //--NZ 2  TSX
-        {
-            XR = SP;
-            NZ(XR);
-            usedCycles += 2;
-        } break;
-        case 0xBB:  //--NZ 4+ LAR $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            UINT8 val = PEEK(addr);
-            XR = AC = SP &= val;
-            NZ(XR);
-            POKE(addr, XR);
-            usedCycles += 4;
-        } break;
-        case 0xBC:  //--NZ 4+ LDY $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            YR = PEEK(addr);
-            NZ(YR);
-            usedCycles += 4;
-        } break;
-        case 0xBD:  //--NZ 4+ LDA $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            AC = PEEK(addr);
-            NZ(AC);
-            usedCycles += 4;
-        } break;
-        case 0xBE:  //--NZ 4+ LDX $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            XR = PEEK(addr);
-            NZ(XR);
-            usedCycles += 4;
-        } break;
-        case 0xBF:  //--NZ 4+ LAX $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            UINT8 val = PEEK(addr);
-            XR = AC = val;
-            NZ(XR);
-            usedCycles += 4;
-        } break;
-        case 0xC0:  //C-NZ 2  CPY #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            CPY(addr);
-            usedCycles += 2;
-        } break;
-        case 0xC1:  //C-NZ 6  CMP ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            CMP(addr);
-            usedCycles += 6;
-        } break;
-        case 0xC2:  //---- 2  DOP
-        {
-            PC++;
-            usedCycles += 2;
-        } break;
-        case 0xC3:  //C-NZ 8  DCP ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            DCP(addr);
-            usedCycles += 8;
-        } break;
-        case 0xC4:  //C-NZ 3  CPY $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            CPY(addr);
-            usedCycles += 3;
-        } break;
-        case 0xC5:  //C-NZ 3  CMP $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            CMP(addr);
-            usedCycles += 3;
-        } break;
-        case 0xC6:  //--NZ 5  DEC $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            DEC(addr);
-            usedCycles += 5;
-        } break;
-        case 0xC7:  //C-NZ 5  DCP $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            DCP(addr);
-            usedCycles += 5;
-        } break;
-        case 0xC8:  //--NZ 2  INY
-        {
-            YR++;
-            NZ(YR);
-            usedCycles += 2;
-        } break;
-        case 0xC9:  //C-NZ 2  CMP #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            CMP(addr);
-            usedCycles += 2;
-        } break;
-        case 0xCA:  //--NZ 2  DEX
-        {
-            XR--;
-            NZ(XR);
-            usedCycles += 2;
-        } break;
-        case 0xCB:  //C-NZ 2  AXS #$44
-        {
-            XR &= AC;
-            UINT16 addr = IMMEDIATE();
-            UINT8 data = PEEK(addr);
-		    C = XR >= data;
-		    XR = (UINT8)(XR-data);
-            NZ(XR);
-            usedCycles += 2;
-        } break;
-        case 0xCC:  //C-NZ 4  CPY $4400
-        {
-            UINT16 addr = Absolute();
-            CPY(addr);
-            usedCycles += 4;
-        } break;
-        case 0xCD:  //C-NZ 4  CMP $4400
-        {
-            UINT16 addr = Absolute();
-            CMP(addr);
-            usedCycles += 4;
-        } break;
-        case 0xCE:  //--NZ 6  DEC $4400
-        {
-            UINT16 addr = Absolute();
-            DEC(addr);
-            usedCycles += 6;
-        } break;
-        case 0xCF:  //DCP $4400
-        {
-            UINT16 addr = ZERO_PAGE();
-            DCP(addr);
-            usedCycles += 5;
-        } break;
-        case 0xD0:  //---- 2+ BNE
-        {
-            UINT16 addr = IMMEDIATE();
-            INT8 val = (INT8)PEEK(addr);
-            if (!Z) {
-                usedCycles++;
-                BRANCH(val);
-            }
-            usedCycles += 2;
-        } break;
-        case 0xD1:  //C-NZ 5+ CMP ($44),Y
-        {
-            UINT16 addr = INDIRECT_Y();
-            CMP(addr);
-            usedCycles += 5;
-        } break;
-        case 0xD2:  //---- 1  KIL
-        {
-            PC--;
-            usedCycles += 1;
-        } break;
-        case 0xD3:  //C-NZ 8  DCP ($44),Y
-        {
-            UINT16 addr = INDIRECT_Y();
-            DCP(addr);
-            usedCycles += 8;
-        } break;
-        case 0xD4:  //---- 4  DOP
-        {
-            PC++;
-            usedCycles += 4;
-        } break;
-        case 0xD5:  //C-NZ 4  CMP $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            CMP(addr);
-            usedCycles += 4;
-        } break;
-        case 0xD6:  //--NZ 6  DEC $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            DEC(addr);
-            usedCycles += 6;
-        } break;
-        case 0xD7:  //DCP $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            DCP(addr);
-            usedCycles += 6;
-        } break;
-        case 0xD8:  //---- 2  CLD
-        {
-            D = FALSE;
-            usedCycles += 2;
-        } break;
-        case 0xD9:  //C-NZ 4+ CMP $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            CMP(addr);
-            usedCycles += 4;
-        } break;
-        case 0xDA:  //---- 2  NOP
-        {
-            usedCycles += 2;
-        } break;
-        case 0xDB:  //C-NZ 7  DCP $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            DCP(addr);
-            usedCycles += 7;
-        } break;
-        case 0xDC:  //---- 4+ TOP
-        {
-            PC += 2;
-            usedCycles += 4;
-        } break;
-        case 0xDD:  //C-NZ 4+ CMP $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            CMP(addr);
-            usedCycles += 4;
-        } break;
-        case 0xDE:  //--NZ 7  DEC $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            DEC(addr);
-            usedCycles += 7;
-        } break;
-        case 0xDF:  //C-NZ 7  DCP $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            DCP(addr);
-            usedCycles += 7;
-        } break;
-        case 0xE0:  //C-NZ 2  CPX #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            CPX(addr);
-            usedCycles += 2;
-        } break;
-        case 0xE1:  //CVNZ 6  SBC ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            SBC(addr);
-            usedCycles += 6;
-        } break;
-        case 0xE2:  //---- 2  DOP
-        {
-            PC++;
-            usedCycles += 2;
-        } break;
-        case 0xE3:  //CVNZ 8  ISC ($44,X)
-        {
-            UINT16 addr = INDIRECT_X();
-            ISC(addr);
-            usedCycles += 8;
-        } break;
-        case 0xE4:  //C-NZ 3  CPX $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            CPX(addr);
-            usedCycles += 3;
-        } break;
-        case 0xE5:  //CVNZ 3  SBC $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            SBC(addr);
-            usedCycles += 3;
-        } break;
-        case 0xE6:  //--NZ 5  INC $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            INC(addr);
-            usedCycles += 5;
-        } break;
-        case 0xE7:  //CVNZ 5  ISC $44
-        {
-            UINT16 addr = ZERO_PAGE();
-            ISC(addr);
-            usedCycles += 5;
-        } break;
-        case 0xE8:  //--NZ 2  INX
-        {
-            XR++;
-            NZ(XR);
-            usedCycles += 2;
-        } break;
-        case 0xE9:  //CVNZ 2  SBC #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            SBC(addr);
-            usedCycles += 2;
-        } break;
-        case 0xEA:  //---- 2  NOP
-        {
-            usedCycles += 2;
-        } break;
-        case 0xEB:  //CVNZ 2  SBC #$44
-        {
-            UINT16 addr = IMMEDIATE();
-            SBC(addr);
-            usedCycles += 2;
-        } break;
-        case 0xEC:  //C-NZ 4  CPX $4400
-        {
-            UINT16 addr = Absolute();
-            CPX(addr);
-            usedCycles += 4;
-        } break;
-        case 0xED:  //CVNZ 4  SBC $4400
-        {
-            UINT16 addr = Absolute();
-            SBC(addr);
-            usedCycles += 4;
-        } break;
-        case 0xEE:  //--NZ 6  INC $4400
-        {
-            UINT16 addr = Absolute();
-            INC(addr);
-            usedCycles += 6;
-        } break;
-        case 0xEF:  //CVNZ 6  ISC $4400
-        {
-            UINT16 addr = Absolute();
-            ISC(addr);
-            usedCycles += 6;
-        } break;
-        case 0xF0:  //---- 2|3+ BEQ
-        {
-            UINT16 addr = IMMEDIATE();
-            INT8 val = (INT8)PEEK(addr);
-            if (Z) {
-                usedCycles++;
-                BRANCH(val);
-            }
-            usedCycles += 2;
-        } break;
-        case 0xF1:  //CVNZ 5+ SBC ($44),Y
-        {
-            UINT16 addr = INDIRECT_Y();
-            SBC(addr);
-            usedCycles += 5;
-        } break;
-        case 0xF2:  //---- 1  KIL
-        {
-            PC--;
-            usedCycles += 1;
-        } break;
-        case 0xF3:  //CVNZ 8  ISC ($44),Y
-        {
-            UINT16 addr = ZERO_PAGE();
-            ISC(addr);
-            usedCycles += 8;
-        } break;
-        case 0xF4:  //---- 4  DOP
-        {
-            PC++;
-            usedCycles += 4;
-        } break;
-        case 0xF5:  //CVNZ 4  SBC $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            SBC(addr);
-            usedCycles += 4;
-        } break;
-        case 0xF6:  //--NZ 6  INC $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            INC(addr);
-            usedCycles += 6;
-        } break;
-        case 0xF7:  //ISC $44,X
-        {
-            UINT16 addr = ZERO_PAGE_X();
-            ISC(addr);
-            usedCycles += 6;
-        } break;
-        case 0xF8:  //SED
-        {
-            D = TRUE;
-            usedCycles += 2;
-        } break;
-        case 0xF9:  //CVNZ 4+ SBC $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            SBC(addr);
-            usedCycles += 4;
-        } break;
-        case 0xFA:  //---- 2  NOP
-        {
-            usedCycles += 2;
-        } break;
-        case 0xFB:  //ISC $4400,Y
-        {
-            UINT16 addr = Absolute_Y();
-            ISC(addr);
-            usedCycles += 6;
-        } break;
-        case 0xFC:  //---- 4+ TOP
-        {
-            PC += 2;
-            usedCycles += 4;
-        } break;
-        case 0xFD:  //CVNZ 4+ SBC $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            SBC(addr);
-            usedCycles += 4;
-        } break;
-        case 0xFE:  //--NZ 7  INC $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            INC(addr);
-            usedCycles += 7;
-        } break;
-        case 0xFF:  //CVNZ 7  ISC $4400,X
-        {
-            UINT16 addr = Absolute_X();
-            ISC(addr);
-            usedCycles += 7;
-        } break;
+
+    //fetch the opcode and its operand, from the pre-decoded copy if the
+    //instruction sits in ROM
+    UINT8 op;
+    const DecodedInstruction* decoded = decodedPages[PC >> 8];
+    if (decoded != NULL && decoded[PC & 0xFF].decoded) {
+        decoded += (PC & 0xFF);
+        op = decoded->opcode;
+        operand = decoded->operand;
+    }
+    else {
+        op = PEEK(PC);
+        switch (INSTRUCTIONS[op].operandSize) {
+            case 2:
+                operand = (UINT16)(PEEK((UINT16)(PC+1)) | (PEEK((UINT16)(PC+2)) << 8));
+                break;
+            case 1:
+                operand = PEEK((UINT16)(PC+1));
+                break;
+        }
     }
+    PC = (UINT16)(PC + 1 + INSTRUCTIONS[op].operandSize);
+    usedCycles += (this->*INSTRUCTIONS[op].execute)();
+
     } while (usedCycles < minimum);
-    
     return usedCycles;
 }
 
@@ -1707,360 +316,1108 @@ void _6502c::SPLIT_SR(UINT8 x)
     C = !!(x & 0x01);
 }
 
+//the zero page and the stack go straight to their RAM when it is known
+UINT8 _6502c::PEEK_DIRECT(UINT16 addr)
+{
+    if (directPages)
+        return directPages->peekDirect(addr);
+    return PEEK(addr);
+}
+
+void _6502c::POKE_DIRECT(UINT16 addr, UINT8 val)
+{
+    if (directPages)
+        directPages->pokeDirect(addr, val);
+    else
+        POKE(addr, val);
+}
+
 void _6502c::PUSH(UINT8 x)
 {
-    POKE((UINT16)(0x100|SP), x);
+    POKE_DIRECT((UINT16)(0x100|SP), x);
     SP--;
 }
 
 void _6502c::dPUSH(UINT16 x)
 {
-    POKE((UINT16)(0x100|SP), (UINT16)((x & 0xFF00) >> 8));
+    POKE_DIRECT((UINT16)(0x100|SP), (UINT8)((x & 0xFF00) >> 8));
     SP--;
-    POKE((UINT16)(0x100|SP), (UINT16)(x & 0x00FF));
+    POKE_DIRECT((UINT16)(0x100|SP), (UINT8)(x & 0x00FF));
     SP--;
 }
 
 UINT8 _6502c::POP()
 {
     SP++;
-    return PEEK((UINT16)(0x100|SP));
+    return PEEK_DIRECT((UINT16)(0x100|SP));
 }
 
 UINT16 _6502c::dPOP()
 {
     SP++;
-    UINT16 x = PEEK((UINT16)(0x100|SP));
+    UINT16 x = PEEK_DIRECT((UINT16)(0x100|SP));
     SP++;
-    x |= (UINT16)(PEEK((UINT16)(0x100|SP)) << 8);
+    x |= (UINT16)(PEEK_DIRECT((UINT16)(0x100|SP)) << 8);
     return x;
 }
 
-void _6502c::BRANCH(INT8 x)
+template<>
+UINT16 _6502c::address<_6502c::ZERO_PAGE>()
 {
-    PC = (UINT16)(PC+x);
+    return (UINT8)operand;
 }
 
-UINT16 _6502c::IMMEDIATE()
+template<>
+UINT16 _6502c::address<_6502c::ZERO_PAGE_X>()
 {
-    UINT16 addr = PC;
-    PC++;
-    return addr;
+    return (UINT8)(operand+XR);
 }
 
-UINT16 _6502c::ZERO_PAGE()
+template<>
+UINT16 _6502c::address<_6502c::ZERO_PAGE_Y>()
 {
-    UINT8 addr = PEEK(PC);
-    PC++;
-    return addr;
+    return (UINT8)(operand+YR);
 }
 
-UINT16 _6502c::ZERO_PAGE_X()
+template<>
+UINT16 _6502c::address<_6502c::Absolute>()
 {
-    UINT8 addr = (UINT8)(PEEK(PC)+XR);
-    PC++;
-    return addr;
+    return operand;
 }
 
-UINT16 _6502c::ZERO_PAGE_Y()
+template<>
+UINT16 _6502c::address<_6502c::Absolute_X>()
 {
-    UINT8 addr = (UINT8)(PEEK(PC)+YR);
-    PC++;
-    return addr;
+    return (UINT16)(operand+XR);
 }
 
-UINT16 _6502c::Absolute()
+template<>
+UINT16 _6502c::address<_6502c::Absolute_Y>()
 {
-    UINT16 addr = (UINT16)(PEEK(PC) | (PEEK((UINT16)(PC+1)) << 8));
-    PC += 2;
-    return addr;
+    return (UINT16)(operand+YR);
 }
 
-UINT16 _6502c::Absolute_X()
+template<>
+UINT16 _6502c::address<_6502c::INDIRECT_X>()
 {
-    UINT16 addr = (UINT16)((PEEK(PC) | (PEEK((UINT16)(PC+1)) << 8))+XR);
-    PC += 2;
-    return addr;
+    UINT8 pointer = (UINT8)(operand+XR);
+    return (UINT16)(PEEK_DIRECT(pointer) | (PEEK_DIRECT((UINT8)(pointer+1)) << 8));
 }
 
-UINT16 _6502c::Absolute_Y()
+template<>
+UINT16 _6502c::address<_6502c::INDIRECT_Y>()
 {
-    UINT16 addr = (UINT16)((PEEK(PC) | (PEEK((UINT16)(PC+1)) << 8))+YR);
-    PC += 2;
-    return addr;
+    UINT8 pointer = (UINT8)operand;
+    return (UINT16)((PEEK_DIRECT(pointer) | (PEEK_DIRECT((UINT8)(pointer+1)) << 8)) + YR);
 }
 
-UINT16 _6502c::INDIRECT_X()
+template<_6502c::AddressingMode MODE>
+UINT8 _6502c::load(UINT16 addr)
 {
-    UINT16 addr = (UINT16)(PEEK((UINT8)(PEEK(PC)+XR)) |
-        (PEEK((UINT8)(PEEK(PC)+XR+1)) << 8));
-    PC++;
-    return addr;
+    //the zero page modes cannot leave page 0, so they never need the bus
+    if (MODE == ZERO_PAGE || MODE == ZERO_PAGE_X || MODE == ZERO_PAGE_Y)
+        return PEEK_DIRECT(addr);
+    return PEEK(addr);
 }
 
-UINT16 _6502c::INDIRECT_Y()
+template<_6502c::AddressingMode MODE>
+void _6502c::store(UINT16 addr, UINT8 val)
 {
-    UINT16 addr = (UINT16)((PEEK((UINT8)PEEK(PC)) |
-        (PEEK((UINT8)(PEEK(PC)+1)) << 8)) + YR);
-    PC++;
-    return addr;
+    if (MODE == ZERO_PAGE || MODE == ZERO_PAGE_X || MODE == ZERO_PAGE_Y)
+        POKE_DIRECT(addr, val);
+    else
+        POKE(addr, val);
 }
 
-void _6502c::INC(UINT16 addr)
+template<_6502c::AddressingMode MODE>
+UINT8 _6502c::fetch()
 {
-    UINT8 val = PEEK(addr);
-    val++;
-    POKE(addr, val);
-    NZ(val);
+    return load<MODE>(address<MODE>());
 }
 
-void _6502c::DEC(UINT16 addr)
+template<>
+UINT8 _6502c::fetch<_6502c::IMMEDIATE>()
 {
-    UINT8 val = PEEK(addr);
-    val--;
-    POKE(addr, val);
-    NZ(val);
+    return (UINT8)operand;
 }
 
-void _6502c::SLO(UINT16 addr)
+void _6502c::bADC(UINT16 x)
 {
-    UINT8 val = PEEK(addr);
-    C = !!(val & 0x80);
-    val <<= 1;
-    POKE(addr, val);
-    AC |= val;
+    UINT16 tmp = (UINT16)(AC + x + (C ? 1 : 0));
+    C = !!(tmp & 0x100);
+    V = (((AC ^ x) & 0x80) & ((AC ^ tmp) & 0x80)) == 0;
+    AC = (UINT8)tmp;
     NZ(AC);
 }
 
-void _6502c::ASL(UINT16 addr)
+void _6502c::dADC(UINT16 x)
 {
-    UINT8 val = PEEK(addr);
-    C = !!(val & 0x80);
-    val <<= 1;
-    POKE(addr, val);
-    NZ(val);
+    UINT16 result = DECIMAL_ADC[C ? 1 : 0][AC][(UINT8)x];
+    AC = (UINT8)result;
+    N = !!(result & 0x8000);
+    V = !!(result & 0x4000);
+    Z = !!(result & 0x0200);
+    C = !!(result & 0x0100);
 }
 
-void _6502c::AAC(UINT16 addr)
+void _6502c::bSBC(UINT16 x)
 {
-    AC &= PEEK(addr);
-    C = !!(AC & 0x80);
+    UINT16 tmp = (UINT16)(AC - x - (C ? 0 : 1));
+    C = !(tmp & 0x100);
+	V = ((AC ^ tmp) & 0x80) && ((AC ^ x) & 0x80);
+    AC = (UINT8)tmp;
     NZ(AC);
 }
-void _6502c::ASR(UINT16 addr)
+
+void _6502c::dSBC(UINT16 x)
 {
-    UINT8 val = PEEK(addr);
-    C = (val & 0x01) != 0;
-    val >>= 1; POKE(addr, val);
-    NZ(val);
+    UINT16 result = DECIMAL_SBC[C ? 1 : 0][AC][(UINT8)x];
+    AC = (UINT8)result;
+    N = !!(result & 0x8000);
+    V = !!(result & 0x4000);
+    Z = !!(result & 0x0200);
+    C = !!(result & 0x0100);
 }
 
-void _6502c::LSL(UINT16 addr)
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::ORA()
 {
-    UINT8 val = PEEK(addr);
-    C = 0 != (val & 0x80);
-    val = (UINT8)((val<<1) | (C ? 1 : 0));
-    POKE(addr, val);
-    NZ(val);
+    AC |= fetch<MODE>();
+    NZ(AC);
+    return CYCLES;
 }
 
-void _6502c::RLA(UINT16 addr)
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::AND()
 {
-    UINT8 val = PEEK(addr);
-    BOOL c = C;
-    C = !!(val & 0x80);
-    val = (UINT8)((val<<1) | (c ? 1 : 0));
-    POKE(addr, val);
-    AC &= val;
+    AC &= fetch<MODE>();
     NZ(AC);
+    return CYCLES;
 }
 
-void _6502c::ROL(UINT16 addr)
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::EOR()
 {
-    UINT8 val = PEEK(addr);
-    BOOL c = C;
+    AC ^= fetch<MODE>();
+    NZ(AC);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::ADC()
+{
+    UINT8 val = fetch<MODE>();
+    if (D) {
+        dADC(val);
+    } 
+    else {
+        bADC(val);
+    }
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::SBC()
+{
+    UINT8 val = fetch<MODE>();
+    if (D) {
+        dSBC(val);
+    } 
+    else {
+        bSBC(val);
+    }
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::CMP()
+{
+    UINT8 val = fetch<MODE>();
+    UINT16 t = (UINT16)(AC - val);
+    C = (AC >= val);
+    NZ(t);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::CPX()
+{
+    UINT8 val = fetch<MODE>();
+    UINT16 t = (UINT16)(XR - val);
+    C = (XR >= val);
+    NZ(t);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::CPY()
+{
+    UINT8 val = fetch<MODE>();
+    UINT16 t = (UINT16)(YR - val);
+    C = (YR >= val);
+    NZ(t);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::BIT()
+{
+    UINT8 val = fetch<MODE>();
+    Z = (val & AC) == 0;
+    N = !!(val & 0x80);
+    V = !!(val & 0x40);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::LDA()
+{
+    AC = fetch<MODE>();
+    NZ(AC);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::LDX()
+{
+    XR = fetch<MODE>();
+    NZ(XR);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::LDY()
+{
+    YR = fetch<MODE>();
+    NZ(YR);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::LAX()
+{
+    UINT8 val = fetch<MODE>();
+    XR = AC = val;
+    NZ(XR);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::STA()
+{
+    store<MODE>(address<MODE>(), AC);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::STX()
+{
+    store<MODE>(address<MODE>(), XR);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::STY()
+{
+    store<MODE>(address<MODE>(), YR);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::AAX()
+{
+    store<MODE>(address<MODE>(), (UINT8)(AC & XR));
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::INC()
+{
+    UINT16 addr = address<MODE>();
+    UINT8 val = load<MODE>(addr);
+    val++;
+    store<MODE>(addr, val);
+    NZ(val);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::DEC()
+{
+    UINT16 addr = address<MODE>();
+    UINT8 val = load<MODE>(addr);
+    val--;
+    store<MODE>(addr, val);
+    NZ(val);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::ASL()
+{
+    UINT16 addr = address<MODE>();
+    UINT8 val = load<MODE>(addr);
     C = !!(val & 0x80);
-    val = (UINT8)((val<<1) | (c ? 1 : 0));
-    POKE(addr, val);
+    val <<= 1;
+    store<MODE>(addr, val);
     NZ(val);
+    return CYCLES;
 }
 
-void _6502c::SRE(UINT16 addr)
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::LSR()
 {
-    UINT8 val = PEEK(addr);
+    UINT16 addr = address<MODE>();
+    UINT8 val = load<MODE>(addr);
     C = (val & 0x01);
     val >>= 1;
-    POKE(addr, val);
-    AC ^= val;
-    NZ(AC);
+    store<MODE>(addr, val);
+    NZ(val);
+    return CYCLES;
 }
 
-void _6502c::LSR(UINT16 addr)
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::ROL()
 {
-    UINT8 val = PEEK(addr);
-    C = (val & 0x01);
-    val >>= 1;
-    POKE(addr, val);
+    UINT16 addr = address<MODE>();
+    UINT8 val = load<MODE>(addr);
+    BOOL c = C;
+    C = !!(val & 0x80);
+    val = (UINT8)((val<<1) | (c ? 1 : 0));
+    store<MODE>(addr, val);
     NZ(val);
+    return CYCLES;
 }
 
-void _6502c::ROR(UINT16 addr)
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::ROR()
 {
-    UINT8 val = PEEK(addr);
+    UINT16 addr = address<MODE>();
+    UINT8 val = load<MODE>(addr);
     UINT8 c = (C ? 0x80 : 0);
     C = (val & 0x01);
     val = (UINT8)((val>>1) | c);
-    POKE(addr, val);
+    store<MODE>(addr, val);
     NZ(val);
+    return CYCLES;
 }
 
-void _6502c::ALR(UINT16 addr)
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::SLO()
 {
-    AC &= PEEK(addr);
-    C = (AC & 0x01);
-    AC >>= 1;
+    UINT16 addr = address<MODE>();
+    UINT8 val = load<MODE>(addr);
+    C = !!(val & 0x80);
+    val <<= 1;
+    store<MODE>(addr, val);
+    AC |= val;
+    NZ(AC);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::SRE()
+{
+    UINT16 addr = address<MODE>();
+    UINT8 val = load<MODE>(addr);
+    C = (val & 0x01);
+    val >>= 1;
+    store<MODE>(addr, val);
+    AC ^= val;
+    NZ(AC);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::RLA()
+{
+    UINT16 addr = address<MODE>();
+    UINT8 val = load<MODE>(addr);
+    BOOL c = C;
+    C = !!(val & 0x80);
+    val = (UINT8)((val<<1) | (c ? 1 : 0));
+    store<MODE>(addr, val);
+    AC &= val;
     NZ(AC);
+    return CYCLES;
 }
 
-void _6502c::RRA(UINT16 addr)
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::RRA()
 {
-    UINT8 val = PEEK(addr);
+    UINT16 addr = address<MODE>();
+    UINT8 val = load<MODE>(addr);
     UINT8 c = (C ? 0x80 : 0);
     C = (val & 0x01);
     val = (UINT8)((val>>1) | c);
-    POKE(addr, val);
+    store<MODE>(addr, val);
     if (D) {
         dADC(val);
     }
     else {
         bADC(val);
     }
+    return CYCLES;
 }
 
-void _6502c::BIT(UINT16 addr)
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::DCP()
 {
-    UINT8 val = PEEK(addr);
-    Z = (val & AC) == 0;
-    N = !!(val & 0x80);
-    V = !!(val & 0x40);
+    UINT16 addr = address<MODE>();
+    UINT8 val = load<MODE>(addr);
+    val--;
+    store<MODE>(addr, val);
+    UINT16 t = (UINT16)(AC - val);
+    C = (AC >= val);
+    NZ(t);
+    return CYCLES;
 }
 
-void _6502c::ADC(UINT16 addr)
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::ISC()
 {
-    UINT8 val = PEEK(addr);
+    UINT16 addr = address<MODE>();
+    UINT8 val = load<MODE>(addr);
+    val++;
+    store<MODE>(addr, val);
     if (D) {
-        dADC(val);
+        dSBC(val);
     } 
     else {
-        bADC(val);
+        bSBC(val);
     }
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::AAC()
+{
+    AC &= fetch<MODE>();
+    C = !!(AC & 0x80);
+    NZ(AC);
+    return CYCLES;
+}
+
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::ALR()
+{
+    AC &= fetch<MODE>();
+    C = (AC & 0x01);
+    AC >>= 1;
+    NZ(AC);
+    return CYCLES;
 }
 
-void _6502c::SBC(UINT16 addr)
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::ARR()
 {
-    UINT8 val = PEEK(addr);
+    UINT8 data = AC & fetch<MODE>();
     if (D) {
-        dSBC(val);
-    } 
+        UINT16 tmp = (data >> 1) | (C ? 0x80 : 0);
+        NZ(tmp);
+        V = !!((tmp ^ data) & 0x40);
+        if (((data & 0x0F) + (data & 0x01)) > 5)
+            tmp = (tmp & 0xF0) | ((tmp + 0x6) & 0x0F);
+
+        if (((data & 0xF0) + (data & 0x10)) > 0x50) {
+            tmp = (tmp & 0x0F) | ((tmp + 0x60) & 0xF0);
+            C = TRUE;
+        }
+        else
+            C = FALSE;
+        AC = (UINT8)tmp;
+    }
     else {
-        bSBC(val);
+        AC = (data >> 1) | (C ? 0x80 : 0);
+        NZ(AC);
+        C = !!(AC & 0x40);
+        V = ((AC >> 6) ^ (AC >> 5)) & 1;
     }
+    return CYCLES;
 }
 
-void _6502c::CMP(UINT16 addr)
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::ATX()
 {
-    UINT8 val = PEEK(addr);
-    UINT16 t = (UINT16)(AC - val);
-    C = (AC >= val);
-    NZ(t);
+    UINT8 val = fetch<MODE>();
+    XR = AC &= val;
+    NZ(XR);
+    return CYCLES;
 }
 
-void _6502c::CPY(UINT16 addr)
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::XAA()
 {
-    UINT8 val = PEEK(addr);
-    UINT16 t = (UINT16)(YR - val);
-    C = (YR >= val);
-    NZ(t);
+    UINT8 data = fetch<MODE>();
+    UINT8 tmp = AC & XR & data;
+    NZ(tmp);
+    AC &= XR & (data | 0xEF);
+    return CYCLES;
 }
 
-void _6502c::CPX(UINT16 addr)
+template<_6502c::AddressingMode MODE, INT32 CYCLES>
+INT32 _6502c::LAR()
 {
-    UINT8 val = PEEK(addr);
-    UINT16 t = (UINT16)(XR - val);
-    C = (XR >= val);
-    NZ(t);
+    UINT16 addr = address<MODE>();
+    UINT8 val = load<MODE>(addr);
+    XR = AC = SP &= val;
+    NZ(XR);
+    store<MODE>(addr, XR);
+    return CYCLES;
 }
 
-void _6502c::DCP(UINT16 addr)
+template<BOOL _6502c::*FLAG, BOOL SET>
+INT32 _6502c::BRANCH()
 {
-    UINT8 val = PEEK(addr);
-    val--;
-    POKE(addr, val);
-    UINT16 t = (UINT16)(AC - val);
-    C = (AC >= val);
-    NZ(t);
+    if (SET ? (this->*FLAG) : !(this->*FLAG)) {
+        //TODO: add an extra cycle if we branch across a page boundary
+        PC = (UINT16)(PC+(INT8)operand);
+        return 3;
+    }
+    return 2;
 }
 
-void _6502c::ISC(UINT16 addr)
+template<INT32 CYCLES>
+INT32 _6502c::NOP()
 {
-    UINT8 val = PEEK(addr);
-    val++;
-    POKE(addr, val);
-    if (D) {
-        dSBC(val);
-    } 
-    else {
-        bSBC(val);
+    return CYCLES;
+}
+
+INT32 _6502c::BRK()
+{
+    PC += 2;
+    if (!I) {
+        B = TRUE;
+        dPUSH(PC);
+        UINT8 SR = MERGE_SR();
+        PUSH(SR);
+        PC = (UINT16)(PEEK(irqVector) | PEEK((UINT16)(irqVector+1)) << 8);
     }
+    return 7;
 }
 
-void _6502c::bADC(UINT16 x)
+INT32 _6502c::KIL()
 {
-    UINT16 tmp = (UINT16)(AC + x + (C ? 1 : 0));
-    C = !!(tmp & 0x100);
-    V = (((AC ^ x) & 0x80) & ((AC ^ tmp) & 0x80)) == 0;
-    AC = (UINT8)tmp;
+    PC--;
+    return 1;
+}
+
+INT32 _6502c::JSR()
+{
+    dPUSH(PC);
+    PC = operand;
+    return 6;
+}
+
+INT32 _6502c::RTI()
+{
+    UINT8 sr = POP();
+    SPLIT_SR(sr);
+    PC = dPOP();
+    return 6;
+}
+
+INT32 _6502c::RTS()
+{
+    PC = dPOP();
+    return 6;
+}
+
+INT32 _6502c::JMP()
+{
+    PC = operand;
+    return 3;
+}
+
+INT32 _6502c::JMP_INDIRECT()
+{
+    PC = (UINT16)(PEEK(operand) | (PEEK((UINT16)(operand+1)) << 8));
+    return 5;
+}
+
+INT32 _6502c::PHP()
+{
+    UINT8 sr = MERGE_SR();
+    PUSH(sr);
+    return 3;
+}
+
+INT32 _6502c::PLP()
+{
+    UINT8 sr = POP();
+    SPLIT_SR(sr);
+    return 4;
+}
+
+INT32 _6502c::PHA()
+{
+    PUSH(AC);
+    return 3;
+}
+
+INT32 _6502c::PLA()
+{
+    AC = POP();
     NZ(AC);
+    return 4;
 }
 
-void _6502c::dADC(UINT16 x)
+INT32 _6502c::CLC()
 {
-    UINT16 tmp = (AC & 0x0F) + (x & 0x0F) + (C ? 1 : 0);
-    if (tmp >= 10)
-        tmp = (tmp - 10) | 0x10;
-    tmp += (AC & 0xF0) + (x & 0xF0);
+    C = FALSE;
+    return 2;
+}
 
-    Z = (AC + x + (C ? 1 : 0)) == 0;
-    N = !!(tmp & 0x80);
-    V = (((AC ^ x) & 0x80) & ((AC ^ tmp) & 0x80)) == 0;
-    if (tmp >= 0xA0)
-	    tmp += 0x60;
-    C = !!(tmp & 0x100);
-    AC = (UINT8)tmp;
+INT32 _6502c::SEC()
+{
+    C = TRUE;
+    return 2;
 }
 
-void _6502c::bSBC(UINT16 x)
+INT32 _6502c::CLI()
 {
-    UINT16 tmp = (UINT16)(AC - x - (C ? 0 : 1));
-    C = !(tmp & 0x100);
-	V = ((AC ^ tmp) & 0x80) && ((AC ^ x) & 0x80);
-    AC = (UINT8)tmp;
+    I = FALSE;
+    return 2;
+}
+
+INT32 _6502c::SEI()
+{
+    I = TRUE;
+    return 2;
+}
+
+INT32 _6502c::CLV()
+{
+    V = FALSE;
+    return 2;
+}
+
+INT32 _6502c::CLD()
+{
+    D = FALSE;
+    return 2;
+}
+
+INT32 _6502c::SED()
+{
+    D = TRUE;
+    return 2;
+}
+
+INT32 _6502c::TAX()
+{
+    XR = AC;
+    NZ(XR);
+    return 2;
+}
+
+INT32 _6502c::TXA()
+{
+    AC = XR;
     NZ(AC);
+    return 2;
 }
 
-void _6502c::dSBC(UINT16 x)
+INT32 _6502c::TAY()
 {
-    UINT16 tmp = (UINT16)(AC - x - (C ? 0 : 1));
-    UINT16 al = (UINT16)((AC & 0x0F) - (x & 0x0F) - (C ? 0 : 1));
-    UINT16 ah = (UINT16)((AC >> 4) - (x >> 4));
-    if (al & 0x10) {
-        al -= 6;
-        ah--;
-    }
-    if (ah & 0x10)
-        ah -= 6;
-    C = !(tmp & 0x100);
-    V = (((AC ^ tmp) & 0x80) & ((AC ^ x) & 0x80));
-    NZ(tmp);
-    AC = (UINT8)((ah << 4) | (al & 0x0f));
+    YR = AC;
+    NZ(YR);
+    return 2;
+}
+
+INT32 _6502c::TYA()
+{
+    AC = YR;
+    NZ(AC);
+    return 2;
+}
+
+INT32 _6502c::TSX()
+{
+    XR = SP;
+    NZ(XR);
+    return 2;
+}
+
+INT32 _6502c::TXS()
+{
+    SP = XR;
+    return 2;
+}
+
+INT32 _6502c::INX()
+{
+    XR++;
+    NZ(XR);
+    return 2;
+}
+
+INT32 _6502c::DEX()
+{
+    XR--;
+    NZ(XR);
+    return 2;
+}
+
+INT32 _6502c::INY()
+{
+    YR++;
+    NZ(YR);
+    return 2;
+}
+
+INT32 _6502c::DEY()
+{
+    YR--;
+    NZ(YR);
+    return 2;
+}
+
+INT32 _6502c::ASL_A()
+{
+    C = !!(AC & 0x80);
+    AC <<= 1;
+    NZ(AC);
+    return 2;
+}
+
+INT32 _6502c::LSR_A()
+{
+    C = (AC & 0x01);
+    AC >>= 1;
+    NZ(AC);
+    return 2;
+}
+
+INT32 _6502c::ROL_A()
+{
+    BOOL c = C;
+    C = !!(AC & 0x80);
+    AC = (UINT8)((AC<<1) | (c ? 1 : 0));
+    NZ(AC);
+    return 2;
 }
+
+INT32 _6502c::ROR_A()
+{
+    UINT8 c = (C ? 0x80 : 0);
+    C = (AC & 0x01);
+    AC = (UINT8)((AC>>1) | c);
+    NZ(AC);
+    return 2;
+}
+
+INT32 _6502c::AXS()
+{
+    XR &= AC;
+    UINT8 data = (UINT8)operand;
+    C = XR >= data;
+    XR = (UINT8)(XR-data);
+    NZ(XR);
+    return 2;
+}
+
+INT32 _6502c::AXA_INDIRECT_Y()
+{
+    //TODO: behavior is suspiscious; need to verify
+    UINT16 addr = address<INDIRECT_Y>();
+    UINT8 val = AC & XR & PEEK(addr);
+    POKE(addr, val);
+    return 6;
+}
+
+INT32 _6502c::AXA_Absolute_Y()
+{
+    UINT16 addr = operand;
+    UINT8 val = (UINT8)(AC & XR & ((addr >> 8) + 1));
+    addr = (UINT16)(addr+YR);
+    POKE(addr, val);
+    return 5;
+}
+
+INT32 _6502c::XAS()
+{
+    UINT16 addr = operand;
+    SP = (UINT8)(AC & XR);
+    UINT8 val = (UINT8)(SP & ((addr >> 8) + 1));
+    addr = (UINT16)(addr+YR);
+    POKE(addr, val);
+    return 5;
+}
+
+INT32 _6502c::SYA()
+{
+    UINT16 addr = operand;
+    UINT8 val = (UINT8)(YR & (((addr & 0xFF00) >> 8) + 1));
+    addr = (UINT16)(addr+XR);
+    POKE(addr, val);
+    return 5;
+}
+
+INT32 _6502c::SXA()
+{
+    UINT16 addr = operand;
+    UINT8 val = (UINT8)(XR & ((addr >> 8) + 1));
+    addr = (UINT16)(addr+YR);
+    POKE(addr, val);
+    return 5;
+}
+
+const _6502c::Instruction _6502c::INSTRUCTIONS[256] = {
+    { &_6502c::BRK, 0 },                        //00 BRK
+    { &_6502c::ORA<INDIRECT_X, 6>, 1 },         //01 ORA ($44,X)
+    { &_6502c::KIL, 0 },                        //02 KIL
+    { &_6502c::SLO<INDIRECT_X, 8>, 1 },         //03 SLO ($44,X)
+    { &_6502c::NOP<3>, 1 },                     //04 DOP $44
+    { &_6502c::ORA<ZERO_PAGE, 2>, 1 },          //05 ORA $44
+    { &_6502c::ASL<ZERO_PAGE, 5>, 1 },          //06 ASL $44
+    { &_6502c::SLO<ZERO_PAGE, 5>, 1 },          //07 SLO $44
+    { &_6502c::PHP, 0 },                        //08 PHP
+    { &_6502c::ORA<IMMEDIATE, 2>, 1 },          //09 ORA #$44
+    { &_6502c::ASL_A, 0 },                      //0A ASL A
+    { &_6502c::AAC<IMMEDIATE, 2>, 1 },          //0B AAC #$44
+    { &_6502c::NOP<4>, 2 },                     //0C TOP $4400
+    { &_6502c::ORA<Absolute, 4>, 2 },           //0D ORA $4400
+    { &_6502c::ASL<Absolute, 6>, 2 },           //0E ASL $4400
+    { &_6502c::SLO<Absolute, 6>, 2 },           //0F SLO $4400
+    { &_6502c::BRANCH<&_6502c::N, FALSE>, 1 },  //10 BPL
+    { &_6502c::ORA<INDIRECT_Y, 5>, 1 },         //11 ORA ($44),Y
+    { &_6502c::KIL, 0 },                        //12 KIL
+    { &_6502c::SLO<INDIRECT_Y, 8>, 1 },         //13 SLO ($44),Y
+    { &_6502c::NOP<4>, 1 },                     //14 DOP $44
+    { &_6502c::ORA<ZERO_PAGE_X, 3>, 1 },        //15 ORA $44,X
+    { &_6502c::ASL<ZERO_PAGE_X, 6>, 1 },        //16 ASL $44,X
+    { &_6502c::SLO<ZERO_PAGE_X, 6>, 1 },        //17 SLO $44,X
+    { &_6502c::CLC, 0 },                        //18 CLC
+    { &_6502c::ORA<Absolute_Y, 4>, 2 },         //19 ORA $4400,Y
+    { &_6502c::NOP<2>, 0 },                     //1A NOP
+    { &_6502c::SLO<Absolute_Y, 7>, 2 },         //1B SLO $4400,Y
+    { &_6502c::NOP<4>, 2 },                     //1C TOP $4400
+    { &_6502c::ORA<Absolute_X, 4>, 2 },         //1D ORA $4400,X
+    { &_6502c::ASL<Absolute_X, 7>, 2 },         //1E ASL $4400,X
+    { &_6502c::SLO<Absolute_X, 7>, 2 },         //1F SLO $4400,X
+    { &_6502c::JSR, 2 },                        //20 JSR $4400
+    { &_6502c::AND<INDIRECT_X, 6>, 1 },         //21 AND ($44,X)
+    { &_6502c::KIL, 0 },                        //22 KIL
+    { &_6502c::RLA<INDIRECT_X, 8>, 1 },         //23 RLA ($44,X)
+    { &_6502c::BIT<ZERO_PAGE, 3>, 1 },          //24 BIT $44
+    { &_6502c::AND<ZERO_PAGE, 2>, 1 },          //25 AND $44
+    { &_6502c::ROL<ZERO_PAGE, 5>, 1 },          //26 ROL $44
+    { &_6502c::RLA<ZERO_PAGE, 5>, 1 },          //27 RLA $44
+    { &_6502c::PLP, 0 },                        //28 PLP
+    { &_6502c::AND<IMMEDIATE, 2>, 1 },          //29 AND #$44
+    { &_6502c::ROL_A, 0 },                      //2A ROL A
+    { &_6502c::AAC<IMMEDIATE, 2>, 1 },          //2B AAC #$44
+    { &_6502c::BIT<Absolute, 4>, 2 },           //2C BIT $4400
+    { &_6502c::AND<Absolute, 4>, 2 },           //2D AND $4400
+    { &_6502c::ROL<Absolute, 6>, 2 },           //2E ROL $4400
+    { &_6502c::RLA<Absolute, 6>, 2 },           //2F RLA $4400
+    { &_6502c::BRANCH<&_6502c::N, TRUE>, 1 },   //30 BMI
+    { &_6502c::AND<INDIRECT_Y, 5>, 1 },         //31 AND ($44),Y
+    { &_6502c::KIL, 0 },                        //32 KIL
+    { &_6502c::RLA<INDIRECT_Y, 8>, 1 },         //33 RLA ($44),Y
+    { &_6502c::NOP<4>, 1 },                     //34 DOP $44
+    { &_6502c::AND<ZERO_PAGE_X, 3>, 1 },        //35 AND $44,X
+    { &_6502c::ROL<ZERO_PAGE_X, 6>, 1 },        //36 ROL $44,X
+    { &_6502c::RLA<ZERO_PAGE_X, 6>, 1 },        //37 RLA $44,X
+    { &_6502c::SEC, 0 },                        //38 SEC
+    { &_6502c::AND<Absolute_Y, 4>, 2 },         //39 AND $4400,Y
+    { &_6502c::NOP<2>, 0 },                     //3A NOP
+    { &_6502c::RLA<Absolute_Y, 7>, 2 },         //3B RLA $4400,Y
+    { &_6502c::NOP<4>, 2 },                     //3C TOP $4400
+    { &_6502c::AND<Absolute_X, 4>, 2 },         //3D AND $4400,X
+    { &_6502c::ROL<Absolute_X, 7>, 2 },         //3E ROL $4400,X
+    { &_6502c::RLA<Absolute_X, 7>, 2 },         //3F RLA $4400,X
+    { &_6502c::RTI, 0 },                        //40 RTI
+    { &_6502c::EOR<INDIRECT_X, 6>, 1 },         //41 EOR ($44,X)
+    { &_6502c::KIL, 0 },                        //42 KIL
+    { &_6502c::SRE<INDIRECT_X, 8>, 1 },         //43 SRE ($44,X)
+    { &_6502c::NOP<3>, 1 },                     //44 DOP $44
+    { &_6502c::EOR<ZERO_PAGE, 3>, 1 },          //45 EOR $44
+    { &_6502c::LSR<ZERO_PAGE, 5>, 1 },          //46 LSR $44
+    { &_6502c::SRE<ZERO_PAGE, 5>, 1 },          //47 SRE $44
+    { &_6502c::PHA, 0 },                        //48 PHA
+    { &_6502c::EOR<IMMEDIATE, 2>, 1 },          //49 EOR #$44
+    { &_6502c::LSR_A, 0 },                      //4A LSR A
+    { &_6502c::ALR<IMMEDIATE, 2>, 1 },          //4B ALR #$44
+    { &_6502c::JMP, 2 },                        //4C JMP $4400
+    { &_6502c::EOR<Absolute, 4>, 2 },           //4D EOR $4400
+    { &_6502c::LSR<Absolute, 6>, 2 },           //4E LSR $4400
+    { &_6502c::SRE<Absolute, 6>, 2 },           //4F SRE $4400
+    { &_6502c::BRANCH<&_6502c::V, FALSE>, 1 },  //50 BVC
+    { &_6502c::EOR<INDIRECT_Y, 5>, 1 },         //51 EOR ($44),Y
+    { &_6502c::KIL, 0 },                        //52 KIL
+    { &_6502c::SRE<INDIRECT_Y, 8>, 1 },         //53 SRE ($44),Y
+    { &_6502c::NOP<4>, 1 },                     //54 DOP $44
+    { &_6502c::EOR<ZERO_PAGE_X, 4>, 1 },        //55 EOR $44,X
+    { &_6502c::LSR<ZERO_PAGE_X, 6>, 1 },        //56 LSR $44,X
+    { &_6502c::SRE<ZERO_PAGE_X, 6>, 1 },        //57 SRE $44,X
+    { &_6502c::CLI, 0 },                        //58 CLI
+    { &_6502c::EOR<Absolute_Y, 4>, 2 },         //59 EOR $4400,Y
+    { &_6502c::NOP<2>, 0 },                     //5A NOP
+    { &_6502c::SRE<Absolute_Y, 7>, 2 },         //5B SRE $4400,Y
+    { &_6502c::NOP<4>, 2 },                     //5C TOP $4400
+    { &_6502c::EOR<Absolute_X, 4>, 2 },         //5D EOR $4400,X
+    { &_6502c::LSR<Absolute_X, 7>, 2 },         //5E LSR $4400,X
+    { &_6502c::SRE<Absolute_X, 7>, 2 },         //5F SRE $4400,X
+    { &_6502c::RTS, 0 },                        //60 RTS
+    { &_6502c::ADC<INDIRECT_X, 6>, 1 },         //61 ADC ($44,X)
+    { &_6502c::KIL, 0 },                        //62 KIL
+    { &_6502c::RRA<INDIRECT_X, 8>, 1 },         //63 RRA ($44,X)
+    { &_6502c::NOP<3>, 1 },                     //64 DOP $44
+    { &_6502c::ADC<ZERO_PAGE, 3>, 1 },          //65 ADC $44
+    { &_6502c::ROR<ZERO_PAGE, 5>, 1 },          //66 ROR $44
+    { &_6502c::RRA<ZERO_PAGE, 5>, 1 },          //67 RRA $44
+    { &_6502c::PLA, 0 },                        //68 PLA
+    { &_6502c::ADC<IMMEDIATE, 2>, 1 },          //69 ADC #$44
+    { &_6502c::ROR_A, 0 },                      //6A ROR A
+    { &_6502c::ARR<IMMEDIATE, 2>, 1 },          //6B ARR #$44
+    { &_6502c::JMP_INDIRECT, 2 },               //6C JMP ($4400)
+    { &_6502c::ADC<Absolute, 4>, 2 },           //6D ADC $4400
+    { &_6502c::ROR<Absolute, 6>, 2 },           //6E ROR $4400
+    { &_6502c::RRA<Absolute, 6>, 2 },           //6F RRA $4400
+    { &_6502c::BRANCH<&_6502c::V, TRUE>, 1 },   //70 BVS
+    { &_6502c::ADC<INDIRECT_Y, 5>, 1 },         //71 ADC ($44),Y
+    { &_6502c::KIL, 0 },                        //72 KIL
+    { &_6502c::RRA<INDIRECT_Y, 8>, 1 },         //73 RRA ($44),Y
+    { &_6502c::NOP<4>, 1 },                     //74 DOP $44
+    { &_6502c::ADC<ZERO_PAGE_X, 4>, 1 },        //75 ADC $44,X
+    { &_6502c::ROR<ZERO_PAGE_X, 6>, 1 },        //76 ROR $44,X
+    { &_6502c::RRA<ZERO_PAGE_X, 6>, 1 },        //77 RRA $44,X
+    { &_6502c::SEI, 0 },                        //78 SEI
+    { &_6502c::ADC<Absolute_Y, 4>, 2 },         //79 ADC $4400,Y
+    { &_6502c::NOP<2>, 0 },                     //7A NOP
+    { &_6502c::RRA<Absolute_Y, 7>, 2 },         //7B RRA $4400,Y
+    { &_6502c::NOP<4>, 2 },                     //7C TOP $4400
+    { &_6502c::ADC<Absolute_X, 4>, 2 },         //7D ADC $4400,X
+    { &_6502c::ROR<Absolute_X, 7>, 2 },         //7E ROR $4400,X
+    { &_6502c::RRA<Absolute_X, 7>, 2 },         //7F RRA $4400,X
+    { &_6502c::NOP<2>, 1 },                     //80 DOP $44
+    { &_6502c::STA<INDIRECT_X, 6>, 1 },         //81 STA ($44,X)
+    { &_6502c::NOP<2>, 1 },                     //82 DOP $44
+    { &_6502c::AAX<INDIRECT_X, 6>, 1 },         //83 AAX ($44,X)
+    { &_6502c::STY<ZERO_PAGE, 3>, 1 },          //84 STY $44
+    { &_6502c::STA<ZERO_PAGE, 3>, 1 },          //85 STA $44
+    { &_6502c::STX<ZERO_PAGE, 3>, 1 },          //86 STX $44
+    { &_6502c::AAX<ZERO_PAGE, 3>, 1 },          //87 AAX $44
+    { &_6502c::DEY, 0 },                        //88 DEY
+    { &_6502c::NOP<2>, 1 },                     //89 DOP $44
+    { &_6502c::TXA, 0 },                        //8A TXA
+    { &_6502c::XAA<IMMEDIATE, 2>, 1 },          //8B XAA #$44
+    { &_6502c::STY<Absolute, 4>, 2 },           //8C STY $4400
+    { &_6502c::STA<Absolute, 4>, 2 },           //8D STA $4400
+    { &_6502c::STX<Absolute, 4>, 2 },           //8E STX $4400
+    { &_6502c::AAX<Absolute, 4>, 2 },           //8F AAX $4400
+    { &_6502c::BRANCH<&_6502c::C, FALSE>, 1 },  //90 BCC
+    { &_6502c::STA<INDIRECT_Y, 6>, 1 },         //91 STA ($44),Y
+    { &_6502c::KIL, 0 },                        //92 KIL
+    { &_6502c::AXA_INDIRECT_Y, 1 },             //93 AXA ($44),Y
+    { &_6502c::STY<ZERO_PAGE_X, 4>, 1 },        //94 STY $44,X
+    { &_6502c::STA<ZERO_PAGE_X, 4>, 1 },        //95 STA $44,X
+    { &_6502c::STX<ZERO_PAGE_Y, 4>, 1 },        //96 STX $44,Y
+    { &_6502c::AAX<ZERO_PAGE_Y, 4>, 1 },        //97 AAX $44,Y
+    { &_6502c::TYA, 0 },                        //98 TYA
+    { &_6502c::STA<Absolute_Y, 5>, 2 },         //99 STA $4400,Y
+    { &_6502c::TXS, 0 },                        //9A TXS
+    { &_6502c::XAS, 2 },                        //9B XAS $4400,Y
+    { &_6502c::SYA, 2 },                        //9C SYA $4400,X
+    { &_6502c::STA<Absolute_X, 5>, 2 },         //9D STA $4400,X
+    { &_6502c::SXA, 2 },                        //9E SXA $4400,Y
+    { &_6502c::AXA_Absolute_Y, 2 },             //9F AXA $4400,Y
+    { &_6502c::LDY<IMMEDIATE, 2>, 1 },          //A0 LDY #$44
+    { &_6502c::LDA<INDIRECT_X, 6>, 1 },         //A1 LDA ($44,X)
+    { &_6502c::LDX<IMMEDIATE, 2>, 1 },          //A2 LDX #$44
+    { &_6502c::LAX<INDIRECT_X, 6>, 1 },         //A3 LAX ($44,X)
+    { &_6502c::LDY<ZERO_PAGE, 3>, 1 },          //A4 LDY $44
+    { &_6502c::LDA<ZERO_PAGE, 3>, 1 },          //A5 LDA $44
+    { &_6502c::LDX<ZERO_PAGE, 3>, 1 },          //A6 LDX $44
+    { &_6502c::LAX<ZERO_PAGE, 3>, 1 },          //A7 LAX $44
+    { &_6502c::TAY, 0 },                        //A8 TAY
+    { &_6502c::LDA<IMMEDIATE, 2>, 1 },          //A9 LDA #$44
+    { &_6502c::TAX, 0 },                        //AA TAX
+    { &_6502c::ATX<IMMEDIATE, 2>, 1 },          //AB ATX #$44
+    { &_6502c::LDY<Absolute, 4>, 2 },           //AC LDY $4400
+    { &_6502c::LDA<Absolute, 4>, 2 },           //AD LDA $4400
+    { &_6502c::LDX<Absolute, 4>, 2 },           //AE LDX $4400
+    { &_6502c::LAX<Absolute, 4>, 2 },           //AF LAX $4400
+    { &_6502c::BRANCH<&_6502c::C, TRUE>, 1 },   //B0 BCS
+    { &_6502c::LDA<INDIRECT_Y, 5>, 1 },         //B1 LDA ($44),Y
+    { &_6502c::KIL, 0 },                        //B2 KIL
+    { &_6502c::LAX<INDIRECT_Y, 5>, 1 },         //B3 LAX ($44),Y
+    { &_6502c::LDY<ZERO_PAGE_X, 4>, 1 },        //B4 LDY $44,X
+    { &_6502c::LDA<ZERO_PAGE_X, 4>, 1 },        //B5 LDA $44,X
+    { &_6502c::LDX<ZERO_PAGE_Y, 4>, 1 },        //B6 LDX $44,Y
+    { &_6502c::LAX<ZERO_PAGE_Y, 4>, 1 },        //B7 LAX $44,Y
+    { &_6502c::CLV, 0 },                        //B8 CLV
+    { &_6502c::LDA<Absolute_Y, 4>, 2 },         //B9 LDA $4400,Y
+    { &_6502c::TSX, 0 },                        //BA TSX
+    { &_6502c::LAR<Absolute_Y, 4>, 2 },         //BB LAR $4400,Y
+    { &_6502c::LDY<Absolute_X, 4>, 2 },         //BC LDY $4400,X
+    { &_6502c::LDA<Absolute_X, 4>, 2 },         //BD LDA $4400,X
+    { &_6502c::LDX<Absolute_Y, 4>, 2 },         //BE LDX $4400,Y
+    { &_6502c::LAX<Absolute_Y, 4>, 2 },         //BF LAX $4400,Y
+    { &_6502c::CPY<IMMEDIATE, 2>, 1 },          //C0 CPY #$44
+    { &_6502c::CMP<INDIRECT_X, 6>, 1 },         //C1 CMP ($44,X)
+    { &_6502c::NOP<2>, 1 },                     //C2 DOP $44
+    { &_6502c::DCP<INDIRECT_X, 8>, 1 },         //C3 DCP ($44,X)
+    { &_6502c::CPY<ZERO_PAGE, 3>, 1 },          //C4 CPY $44
+    { &_6502c::CMP<ZERO_PAGE, 3>, 1 },          //C5 CMP $44
+    { &_6502c::DEC<ZERO_PAGE, 5>, 1 },          //C6 DEC $44
+    { &_6502c::DCP<ZERO_PAGE, 5>, 1 },          //C7 DCP $44
+    { &_6502c::INY, 0 },                        //C8 INY
+    { &_6502c::CMP<IMMEDIATE, 2>, 1 },          //C9 CMP #$44
+    { &_6502c::DEX, 0 },                        //CA DEX
+    { &_6502c::AXS, 1 },                        //CB AXS #$44
+    { &_6502c::CPY<Absolute, 4>, 2 },           //CC CPY $4400
+    { &_6502c::CMP<Absolute, 4>, 2 },           //CD CMP $4400
+    { &_6502c::DEC<Absolute, 6>, 2 },           //CE DEC $4400
+    { &_6502c::DCP<Absolute, 5>, 2 },           //CF DCP $4400
+    { &_6502c::BRANCH<&_6502c::Z, FALSE>, 1 },  //D0 BNE
+    { &_6502c::CMP<INDIRECT_Y, 5>, 1 },         //D1 CMP ($44),Y
+    { &_6502c::KIL, 0 },                        //D2 KIL
+    { &_6502c::DCP<INDIRECT_Y, 8>, 1 },         //D3 DCP ($44),Y
+    { &_6502c::NOP<4>, 1 },                     //D4 DOP $44
+    { &_6502c::CMP<ZERO_PAGE_X, 4>, 1 },        //D5 CMP $44,X
+    { &_6502c::DEC<ZERO_PAGE_X, 6>, 1 },        //D6 DEC $44,X
+    { &_6502c::DCP<ZERO_PAGE_X, 6>, 1 },        //D7 DCP $44,X
+    { &_6502c::CLD, 0 },                        //D8 CLD
+    { &_6502c::CMP<Absolute_Y, 4>, 2 },         //D9 CMP $4400,Y
+    { &_6502c::NOP<2>, 0 },                     //DA NOP
+    { &_6502c::DCP<Absolute_Y, 7>, 2 },         //DB DCP $4400,Y
+    { &_6502c::NOP<4>, 2 },                     //DC TOP $4400
+    { &_6502c::CMP<Absolute_X, 4>, 2 },         //DD CMP $4400,X
+    { &_6502c::DEC<Absolute_X, 7>, 2 },         //DE DEC $4400,X
+    { &_6502c::DCP<Absolute_X, 7>, 2 },         //DF DCP $4400,X
+    { &_6502c::CPX<IMMEDIATE, 2>, 1 },          //E0 CPX #$44
+    { &_6502c::SBC<INDIRECT_X, 6>, 1 },         //E1 SBC ($44,X)
+    { &_6502c::NOP<2>, 1 },                     //E2 DOP $44
+    { &_6502c::ISC<INDIRECT_X, 8>, 1 },         //E3 ISC ($44,X)
+    { &_6502c::CPX<ZERO_PAGE, 3>, 1 },          //E4 CPX $44
+    { &_6502c::SBC<ZERO_PAGE, 3>, 1 },          //E5 SBC $44
+    { &_6502c::INC<ZERO_PAGE, 5>, 1 },          //E6 INC $44
+    { &_6502c::ISC<ZERO_PAGE, 5>, 1 },          //E7 ISC $44
+    { &_6502c::INX, 0 },                        //E8 INX
+    { &_6502c::SBC<IMMEDIATE, 2>, 1 },          //E9 SBC #$44
+    { &_6502c::NOP<2>, 0 },                     //EA NOP
+    { &_6502c::SBC<IMMEDIATE, 2>, 1 },          //EB SBC #$44
+    { &_6502c::CPX<Absolute, 4>, 2 },           //EC CPX $4400
+    { &_6502c::SBC<Absolute, 4>, 2 },           //ED SBC $4400
+    { &_6502c::INC<Absolute, 6>, 2 },           //EE INC $4400
+    { &_6502c::ISC<Absolute, 6>, 2 },           //EF ISC $4400
+    { &_6502c::BRANCH<&_6502c::Z, TRUE>, 1 },   //F0 BEQ
+    { &_6502c::SBC<INDIRECT_Y, 5>, 1 },         //F1 SBC ($44),Y
+    { &_6502c::KIL, 0 },                        //F2 KIL
+    { &_6502c::ISC<INDIRECT_Y, 8>, 1 },         //F3 ISC ($44),Y
+    { &_6502c::NOP<4>, 1 },                     //F4 DOP $44
+    { &_6502c::SBC<ZERO_PAGE_X, 4>, 1 },        //F5 SBC $44,X
+    { &_6502c::INC<ZERO_PAGE_X, 6>, 1 },        //F6 INC $44,X
+    { &_6502c::ISC<ZERO_PAGE_X, 6>, 1 },        //F7 ISC $44,X
+    { &_6502c::SED, 0 },                        //F8 SED
+    { &_6502c::SBC<Absolute_Y, 4>, 2 },         //F9 SBC $4400,Y
+    { &_6502c::NOP<2>, 0 },                     //FA NOP
+    { &_6502c::ISC<Absolute_Y, 6>, 2 },         //FB ISC $4400,Y
+    { &_6502c::NOP<4>, 2 },                     //FC TOP $4400
+    { &_6502c::SBC<Absolute_X, 4>, 2 },         //FD SBC $4400,X
+    { &_6502c::INC<Absolute_X, 7>, 2 },         //FE INC $4400,X
+    { &_6502c::ISC<Absolute_X, 7>, 2 }          //FF ISC $4400,X
+};
@@ -5,27 +5,105 @@
 #include "Processor.h"
 #include "SignalLine.h"
 #include "core/memory/MemoryBus.h"
+#include "core/memory/WatchedRAM.h"
 
 #define _6502C_PIN_IN_NMI   0
 #define _6502C_PIN_IN_HALT  1
 #define _6502C_PIN_IN_READY 2
 #define _6502C_PIN_IN_IRQ   3
 
+TYPEDEF_STRUCT_PACK( _6502cState
+{
+    INT8     N;
+    INT8     V;
+    INT8     B;
+    INT8     D;
+    INT8     I;
+    INT8     Z;
+    INT8     C;
+    UINT8    pins;
+    UINT8    AC;
+    UINT8    XR;
+    UINT8    YR;
+    UINT8    SP;
+    UINT16   PC;
+} _6502cState; )
+
 class _6502c : public Processor
 {
 public:
     _6502c(MemoryBus* memoryBus);
+    virtual ~_6502c();
     
     INT32 getClockSpeed() { return 1792080; }
     
     void resetProcessor();
     
     INT32 tick(INT32 minimum);
+    INT32 getTicksElapsed() { return usedCycles; }
+
+    /**
+     * Lets the processor reach the zero page and the stack page in the given
+     * RAM directly instead of through the memory bus. The RAM must span
+     * addresses $0000 to $01FF and be the only memory mapped there.
+     */
+    void setDirectPages(WatchedRAM* ram);
+
+    _6502cState getState();
+    void setState(_6502cState state);
 
 private:
+    /**
+     * The addressing modes, passed to the instruction templates so that each
+     * opcode is compiled with its own operand decoding.
+     */
+    enum AddressingMode {
+        IMMEDIATE,
+        ZERO_PAGE,
+        ZERO_PAGE_X,
+        ZERO_PAGE_Y,
+        Absolute,
+        Absolute_X,
+        Absolute_Y,
+        INDIRECT_X,
+        INDIRECT_Y
+    };
+
+    /**
+     * An entry in the opcode table: the function executing the instruction,
+     * which returns the cycles it used, and how many operand bytes follow
+     * the opcode.
+     */
+    typedef struct _Instruction {
+        INT32 (_6502c::*execute)();
+        UINT8 operandSize;
+    } Instruction;
+
+    /**
+     * An instruction in ROM, decoded once when the processor is reset.
+     */
+    typedef struct _DecodedInstruction {
+        UINT8  opcode;
+        BOOL   decoded;
+        UINT16 operand;
+    } DecodedInstruction;
+
     const static UINT16 resetVector;
     const static UINT16 irqVector;
     const static UINT16 nmiVector;
+    const static Instruction INSTRUCTIONS[256];
+
+    /**
+     * The decimal mode results of ADC and SBC, indexed by [carry][accumulator]
+     * [operand], with the new accumulator in the low byte and the N, V, Z and
+     * C flags in the high byte at their status register positions.
+     */
+    static UINT16 DECIMAL_ADC[2][256][256];
+    static UINT16 DECIMAL_SBC[2][256][256];
+    static void initDecimalTables();
+
+    void decodeReadOnlyPages();
+    void releaseDecodedPages();
 
     //status bits
     BOOL N, V, B, D, I, Z, C;
@@ -36,51 +114,119 @@ private:
     //program counter
     UINT16 PC;
 
+    //the operand bytes of the current instruction
+    UINT16 operand;
+
     //the 64K 8-bit memory bus
     MemoryBus* memoryBus;
 
+    //the RAM holding the zero page and the stack, if reachable directly
+    WatchedRAM* directPages;
+
+    //the cycles run so far in the current call to tick, counted to the
+    //start of the instruction being executed
+    INT32 usedCycles;
+
+    //the pre-decoded instructions of each page in ROM, or NULL
+    DecodedInstruction* decodedPages[256];
+
     UINT8 MERGE_SR();
     void SPLIT_SR(UINT8 x);
+    inline UINT8 PEEK_DIRECT(UINT16 addr);
+    inline void POKE_DIRECT(UINT16 addr, UINT8 val);
     void PUSH(UINT8 x);
     void dPUSH(UINT16 x);
     UINT8 POP();
     UINT16 dPOP();
-    void BRANCH(INT8 x);
-    inline UINT16 IMMEDIATE();
-    inline UINT16 ZERO_PAGE();
-    inline UINT16 ZERO_PAGE_X();
-    inline UINT16 ZERO_PAGE_Y();
-    inline UINT16 Absolute();
-    inline UINT16 Absolute_X();
-    inline UINT16 Absolute_Y();
-    inline UINT16 INDIRECT_X();
-    inline UINT16 INDIRECT_Y();
-    inline void INC(UINT16 addr);
-    inline void DEC(UINT16 addr);
-    inline void SLO(UINT16 addr);
-    inline void ASL(UINT16 addr);
-    inline void AAC(UINT16 addr);
-    inline void ASR(UINT16 addr);
-    inline void LSL(UINT16 addr);
-    inline void RLA(UINT16 addr);
-    inline void ROL(UINT16 addr);
-    inline void SRE(UINT16 addr);
-    inline void LSR(UINT16 addr);
-    inline void ROR(UINT16 addr);
-    inline void ALR(UINT16 addr);
-    inline void RRA(UINT16 addr);
-    inline void BIT(UINT16 addr);
-    inline void ADC(UINT16 addr);
-    inline void SBC(UINT16 addr);
-    inline void CMP(UINT16 addr);
-    inline void CPY(UINT16 addr);
-    inline void CPX(UINT16 addr);
-    inline void DCP(UINT16 addr);
-    inline void ISC(UINT16 addr);
+    template<AddressingMode MODE> inline UINT16 address();
+    template<AddressingMode MODE> inline UINT8 load(UINT16 addr);
+    template<AddressingMode MODE> inline void store(UINT16 addr, UINT8 val);
+    template<AddressingMode MODE> inline UINT8 fetch();
     inline void bADC(UINT16 x);
     inline void dADC(UINT16 x);
     inline void bSBC(UINT16 x);
     inline void dSBC(UINT16 x);
+
+    //instructions with an addressing mode
+    template<AddressingMode MODE, INT32 CYCLES> INT32 ORA();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 AND();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 EOR();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 ADC();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 SBC();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 CMP();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 CPX();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 CPY();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 BIT();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 LDA();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 LDX();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 LDY();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 LAX();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 STA();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 STX();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 STY();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 AAX();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 INC();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 DEC();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 ASL();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 LSR();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 ROL();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 ROR();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 SLO();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 SRE();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 RLA();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 RRA();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 DCP();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 ISC();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 AAC();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 ALR();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 ARR();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 ATX();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 XAA();
+    template<AddressingMode MODE, INT32 CYCLES> INT32 LAR();
+
+    //relative branches, taken when the given flag has the given state
+    template<BOOL _6502c::*FLAG, BOOL SET> INT32 BRANCH();
+
+    //instructions without an addressing mode
+    template<INT32 CYCLES> INT32 NOP();
+    INT32 BRK();
+    INT32 KIL();
+    INT32 JSR();
+    INT32 RTI();
+    INT32 RTS();
+    INT32 JMP();
+    INT32 JMP_INDIRECT();
+    INT32 PHP();
+    INT32 PLP();
+    INT32 PHA();
+    INT32 PLA();
+    INT32 CLC();
+    INT32 SEC();
+    INT32 CLI();
+    INT32 SEI();
+    INT32 CLV();
+    INT32 CLD();
+    INT32 SED();
+    INT32 TAX();
+    INT32 TXA();
+    INT32 TAY();
+    INT32 TYA();
+    INT32 TSX();
+    INT32 TXS();
+    INT32 INX();
+    INT32 DEX();
+    INT32 INY();
+    INT32 DEY();
+    INT32 ASL_A();
+    INT32 LSR_A();
+    INT32 ROL_A();
+    INT32 ROR_A();
+    INT32 AXS();
+    INT32 AXA_INDIRECT_Y();
+    INT32 AXA_Absolute_Y();
+    INT32 XAS();
+    INT32 SYA();
+    INT32 SXA();
 };
 
 #endif
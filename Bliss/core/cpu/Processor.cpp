@@ -4,7 +4,9 @@
 SignalLine nullPin;
 
 Processor::Processor(const char* nm)
-    : name(nm)
+    : name(nm),
+      processorBus(NULL),
+      scheduleQueue(NULL)
 {
     for (UINT8 i = 0; i < MAX_PINS; i++) {
         pinOut[i] = &nullPin;
@@ -46,6 +46,13 @@ class Processor
 
         virtual BOOL isIdle() { return FALSE; };
 
+        /**
+         * Describes how many of its ticks this processor has run so far in
+         * the call to tick() in progress, so that the other processors can
+         * place an access from it within the slice it is running.
+         */
+        virtual INT32 getTicksElapsed() { return 0; }
+
     protected:
         Processor(const char* name);
 
@@ -3,8 +3,12 @@
 
 ProcessorBus::ProcessorBus()
 : processorCount(0),
+  running(false),
+  clockSpeed(0),
+  clock(0),
   startQueue(NULL),
-  endQueue(NULL)
+  endQueue(NULL),
+  currentQueue(NULL)
 {}
 
 ProcessorBus::~ProcessorBus()
@@ -51,6 +55,7 @@ void ProcessorBus::reset()
     
     UINT64 totalClockSpeed = 1;
     startQueue = endQueue = NULL;
+    clock = 0;
 
     //reorder the processor queue so that it is in the natural (starting) order
     for (UINT32 i = 0; i < processorCount; i++) {
@@ -79,40 +84,90 @@ void ProcessorBus::reset()
         p->scheduleQueue->tickFactor = (totalClockSpeed / ((UINT64)p->getClockSpeed()));
         p->resetProcessor();
     }
+    clockSpeed = totalClockSpeed;
 }
 
 void ProcessorBus::run()
 {
     running = true;
     while (running) {
-		// TODO: jeremiah sypult, saw crash when NULL
-		if (startQueue->next == NULL) {
-			break;
-		}
-        //tick the processor that is at the head of the queue
-        int minTicks = (int)((startQueue->next->tick / startQueue->tickFactor) + 1);
-        startQueue->tick = ((UINT64)startQueue->processor->tick(minTicks)) * startQueue->tickFactor;
-
-        //now reschedule the processor for later processing
-        ScheduleQueue* tmp1 = startQueue;
-        while (tmp1->next != NULL && startQueue->tick > tmp1->next->tick) {
-            startQueue->tick -= tmp1->next->tick;
-            tmp1 = tmp1->next;
-        }
+        if (!step())
+            break;
+    }
+}
 
-        //reorganize the scheduling queue
-        ScheduleQueue* queueToShuffle = startQueue;
-        startQueue = startQueue->next;
-        queueToShuffle->previous = tmp1;
-        queueToShuffle->next = tmp1->next;
-        tmp1->next = queueToShuffle;
-        if (queueToShuffle->next != NULL) {
-            queueToShuffle->next->tick -= queueToShuffle->tick;
-            queueToShuffle->next->previous = queueToShuffle;
-        }
-        else
-            endQueue = queueToShuffle;
+/**
+ * Runs the processors for at least the given number of common clock ticks,
+ * or until one of them stops the bus, whichever comes first.
+ *
+ * @return TRUE if the bus was stopped before the ticks had elapsed.
+ */
+BOOL ProcessorBus::runFor(UINT64 ticks)
+{
+    UINT64 endClock = clock + ticks;
+    running = true;
+    while (running && clock < endClock) {
+        if (!step())
+            break;
+    }
+
+    return !running;
+}
+
+BOOL ProcessorBus::step()
+{
+    // TODO: jeremiah sypult, saw crash when NULL
+    if (startQueue->next == NULL) {
+        return FALSE;
+    }
+    //the processor next in line runs once this one is done, so that much
+    //time will have passed on the common clock
+    clock += startQueue->next->tick;
+
+    //tick the processor that is at the head of the queue
+    int minTicks = (int)((startQueue->next->tick / startQueue->tickFactor) + 1);
+    currentQueue = startQueue;
+    startQueue->tick = ((UINT64)startQueue->processor->tick(minTicks)) * startQueue->tickFactor;
+    currentQueue = NULL;
+
+    //now reschedule the processor for later processing
+    ScheduleQueue* tmp1 = startQueue;
+    while (tmp1->next != NULL && startQueue->tick > tmp1->next->tick) {
+        startQueue->tick -= tmp1->next->tick;
+        tmp1 = tmp1->next;
+    }
+
+    //reorganize the scheduling queue
+    ScheduleQueue* queueToShuffle = startQueue;
+    startQueue = startQueue->next;
+    queueToShuffle->previous = tmp1;
+    queueToShuffle->next = tmp1->next;
+    tmp1->next = queueToShuffle;
+    if (queueToShuffle->next != NULL) {
+        queueToShuffle->next->tick -= queueToShuffle->tick;
+        queueToShuffle->next->previous = queueToShuffle;
+    }
+    else
+        endQueue = queueToShuffle;
+
+    return TRUE;
+}
+
+INT64 ProcessorBus::getTicksAhead(Processor* p)
+{
+    if (currentQueue == NULL || p->scheduleQueue == NULL)
+        return 0;
+
+    //the ticking processor started from the head of the queue, and each
+    //processor after it is queued by its distance past the one before
+    INT64 ahead = -((INT64)currentQueue->processor->getTicksElapsed() *
+            (INT64)currentQueue->tickFactor);
+    for (ScheduleQueue* q = currentQueue->next; q != NULL; q = q->next) {
+        ahead += (INT64)q->tick;
+        if (q == p->scheduleQueue)
+            return ahead / (INT64)q->tickFactor;
     }
+    return 0;
 }
 
 void ProcessorBus::stop()
@@ -4,7 +4,6 @@
 
 #include "Processor.h"
 #include "core/types.h"
-#include "core/audio/AudioMixer.h"
 
 const INT32 MAX_PROCESSORS = 15;
 
@@ -22,20 +21,38 @@ public:
 
 	void reset();
 	void run();
+	BOOL runFor(UINT64 ticks);
 	void stop();
 
+	/**
+	 * The rate of the common clock that all of the processors are scheduled
+	 * against, which is the least common multiple of their clock speeds.
+	 */
+	UINT64 getClockSpeed() { return clockSpeed; }
+
+	/**
+	 * Returns how many of its own ticks the given processor has already run
+	 * past the current position of the processor that is ticking, or 0 when
+	 * no processor is. The result is negative if it has yet to catch up.
+	 */
+	INT64 getTicksAhead(Processor* p);
+
 	void halt(Processor* p);
     void unhalt(Processor* p);
     void pause(Processor* p, int ticks);
 
 private:
+	BOOL step();
 	void reschedule(ScheduleQueue*);
 
     UINT32      processorCount;
     Processor*  processors[MAX_PROCESSORS];
 	bool running;
+	UINT64 clockSpeed;
+	UINT64 clock;
 	ScheduleQueue* startQueue;
 	ScheduleQueue* endQueue;
+	ScheduleQueue* currentQueue;
 
 };
 
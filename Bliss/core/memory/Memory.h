@@ -21,6 +21,13 @@ class Memory
         virtual UINT16 getWriteAddressMask() = 0;
         virtual void poke(UINT16 location, UINT16 value) = 0;
 
+        /**
+         * Returns TRUE if the memory can be switched in and out of the bus
+         * while it runs, such as a banked cartridge ROM, so that what reads
+         * back at its addresses may change without any write to them.
+         */
+        virtual BOOL isSwitchable() { return FALSE; }
+
 };
 
 #endif
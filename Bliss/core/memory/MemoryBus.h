@@ -26,6 +26,24 @@ class MemoryBus
         UINT16 peek(UINT16 location);
         void poke(UINT16 location, UINT16 value);
 
+        /**
+         * Returns TRUE if the given address can be read but not written, so
+         * that its contents cannot change until the memory map does.  An
+         * address backed by a switchable memory, such as a ROM under a
+         * ROMBanker, is never read-only, since a bank switch changes what
+         * reads back there without changing the map.
+         */
+        BOOL isReadOnly(UINT16 location) {
+            UINT16 count = readableMemoryCounts[location];
+            if (count == 0 || writeableMemoryCounts[location] != 0)
+                return FALSE;
+            for (UINT16 i = 0; i < count; i++) {
+                if (readableMemorySpace[location][i]->isSwitchable())
+                    return FALSE;
+            }
+            return TRUE;
+        }
+
         void addMemory(Memory* m);
         void removeMemory(Memory* m);
         void removeAll();
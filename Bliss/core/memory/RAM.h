@@ -62,11 +62,11 @@ class RAM : public Memory
         UINT16  location;
         UINT16  readAddressMask;
         UINT16  writeAddressMask;
+        UINT16* image;
 
     private:
         UINT8   bitWidth;
         UINT16  trimmer;
-        UINT16* image;
 };
 
 #endif
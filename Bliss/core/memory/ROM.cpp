@@ -5,6 +5,7 @@
 
 ROM::ROM(const CHAR* n, const CHAR* f, UINT32 o, UINT8 byteWidth, UINT16 size, UINT16 location, BOOL i)
 : enabled(TRUE),
+  switchable(FALSE),
   loaded(FALSE),
   internal(i)
 {
@@ -13,6 +14,7 @@ ROM::ROM(const CHAR* n, const CHAR* f, UINT32 o, UINT8 byteWidth, UINT16 size, U
 
 ROM::ROM(const CHAR* n, void* image, UINT8 byteWidth, UINT16 size, UINT16 location, UINT16 readAddressMask)
 : enabled(TRUE),
+  switchable(FALSE),
   loaded(TRUE),
   internal(FALSE)
 {
@@ -25,6 +25,7 @@ public:
     //enabled attributes
     void SetEnabled(BOOL b);
     BOOL IsEnabled() { return enabled; }
+    void SetSwitchable(BOOL b) { switchable = b; }
 
     //functions to implement the Memory interface
 	virtual void reset() {}
@@ -39,6 +40,7 @@ public:
     UINT16 getWriteAddress();
     UINT16 getWriteAddressMask();
     virtual void poke(UINT16 location, UINT16 value);
+    virtual BOOL isSwitchable() { return switchable; }
 
 private:
     void Initialize(const CHAR* n, const CHAR* f, UINT32 o, UINT8 byteWidth, UINT16 size, UINT16 location, UINT16 readMask);
@@ -56,6 +58,7 @@ private:
     UINT8*    image;
     UINT8    byteWidth;
     BOOL     enabled;
+    BOOL     switchable;
     UINT16   size;
     UINT16   location;
     UINT16   readAddressMask;
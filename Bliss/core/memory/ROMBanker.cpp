@@ -10,7 +10,9 @@ ROMBanker::ROMBanker(ROM* r, UINT16 address, UINT16 tm, UINT16 t, UINT16 mm, UIN
   trigger(t),
   matchMask(mm),
   match(m)
-{}
+{
+    rom->SetSwitchable(TRUE);
+}
 
 void ROMBanker::reset()
 {
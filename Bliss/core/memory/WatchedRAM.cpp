@@ -0,0 +1,29 @@
+
+#include "WatchedRAM.h"
+
+WatchedRAM::WatchedRAM(UINT16 size, UINT16 location)
+: RAM(size, location)
+{
+    memset(pageGenerations, 0, sizeof(pageGenerations));
+}
+
+void WatchedRAM::reset()
+{
+    RAM::reset();
+    markAllWritten();
+}
+
+void WatchedRAM::poke(UINT16 location, UINT16 value)
+{
+    //rewriting the same value leaves the page unchanged
+    UINT16 previous = RAM::peek(location);
+    RAM::poke(location, value);
+    if (RAM::peek(location) != previous)
+        pageGenerations[(UINT16)((location&writeAddressMask) - this->location) >> 8]++;
+}
+
+void WatchedRAM::markAllWritten()
+{
+    for (UINT32 i = 0; i < WATCHED_RAM_MAX_PAGES; i++)
+        pageGenerations[i]++;
+}
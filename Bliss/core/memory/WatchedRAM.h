@@ -0,0 +1,72 @@
+
+#ifndef WATCHEDRAM_H
+#define WATCHEDRAM_H
+
+#include "RAM.h"
+
+#define WATCHED_RAM_PAGE_SIZE   0x100
+#define WATCHED_RAM_MAX_PAGES   0x100
+
+/**
+ * RAM that counts the changes made to each of its 256-byte pages, so that a
+ * consumer can cache data derived from its contents and cheaply check later
+ * whether that data is still current.
+ */
+class WatchedRAM : public RAM
+{
+
+    public:
+        WatchedRAM(UINT16 size, UINT16 location);
+
+        void reset();
+        void poke(UINT16 location, UINT16 value);
+
+        /**
+         * Returns TRUE if the given address lies within this RAM.
+         */
+        BOOL contains(UINT16 location) {
+            return (UINT16)(location - this->location) < size;
+        }
+
+        /**
+         * Returns a counter that changes whenever the page containing the
+         * given address is written. The address must lie within this RAM.
+         */
+        UINT32 getPageGeneration(UINT16 location) {
+            return pageGenerations[(UINT16)(location - this->location) >> 8];
+        }
+
+        /**
+         * Reads a byte straight from the image, bypassing the memory bus, for
+         * processors that keep hot pages such as the stack in this RAM. The
+         * address must lie within this RAM.
+         */
+        UINT8 peekDirect(UINT16 location) {
+            return (UINT8)image[(UINT16)(location - this->location)];
+        }
+
+        /**
+         * Writes a byte straight into the image, bypassing the memory bus but
+         * still counting the change against its page. The address must lie
+         * within this RAM.
+         */
+        void pokeDirect(UINT16 location, UINT8 value) {
+            UINT16 offset = (UINT16)(location - this->location);
+            if (image[offset] != value) {
+                image[offset] = value;
+                pageGenerations[offset >> 8]++;
+            }
+        }
+
+        /**
+         * Marks every page as changed, for use after the contents were
+         * replaced wholesale, such as when loading a saved state.
+         */
+        void markAllWritten();
+
+    private:
+        UINT32 pageGenerations[WATCHED_RAM_MAX_PAGES];
+
+};
+
+#endif
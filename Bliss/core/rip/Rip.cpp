@@ -1,6 +1,8 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <ctype.h>
 
 #include "Rip.h"
 #include "core/memory/RAM.h"
@@ -21,6 +23,7 @@ Rip::Rip(UINT32 systemID)
 : Peripheral("", ""),
   peripheralCount(0),
   targetSystemID(systemID),
+  rowAccurateVideo(FALSE),
   crc(0)
 {
     producer = new CHAR[1];
@@ -342,6 +345,19 @@ Rip* Rip::LoadCartridgeConfiguration(const CHAR* configFile, UINT32 crc)
             rip->AddPeripheralUsage(nextToken+1, pc);
             parseSuccess = TRUE;
         }
+        else if (strncmp(nextLine+8, ":Video:", 7) == 0) {
+            //the key has to be the field right after the crc, and the mode the
+            //field right after the key, so that a title mentioning the word
+            //cannot be taken for a video setting
+            nextToken = nextLine+15;
+
+            if (rip == NULL)
+                rip = new Rip(ID_SYSTEM_INTELLIVISION);
+            if (strncmp(nextToken, "RowAccurate", 11) == 0 &&
+                    (nextToken[11] == '\0' || nextToken[11] == ':' || isspace(nextToken[11])))
+                rip->SetRowAccurateVideo(TRUE);
+            parseSuccess = TRUE;
+        }
     }
     fclose(cfgFile);
 
@@ -35,6 +35,10 @@ public:
 
     PeripheralCompatibility GetPeripheralUsage(const CHAR* periphName);
 
+    //whether the video must be rendered row by row (see AY38900::setRowAccurate)
+    void SetRowAccurateVideo(BOOL b) { this->rowAccurateVideo = b; }
+    BOOL IsRowAccurateVideo() { return rowAccurateVideo; }
+
     //load a regular .rip file
     static Rip* LoadRip(const CHAR* filename);
 
@@ -80,6 +84,8 @@ private:
     PeripheralCompatibility peripheralUsages[MAX_PERIPHERALS];
     UINT32 peripheralCount;
 
+    BOOL rowAccurateVideo;
+
 	CHAR filename[MAX_PATH];
 	UINT32 crc;
 };
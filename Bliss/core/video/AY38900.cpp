@@ -77,13 +77,42 @@ AY38900::AY38900(MemoryBus* mb, ROM* go, GRAM* ga)
     blockTop         = FALSE;
     blockLeft        = FALSE;
     mode             = 0;
+    halfHeightOutput = FALSE;
+    oddRowList       = NULL;
+    renderTarget     = NULL;
+    renderOddRows    = NULL;
+    previousRenderTarget = NULL;
+    rowAccurate      = FALSE;
+    renderForced     = TRUE;
+    frameChanged     = FALSE;
+    renderedFrameChanged = FALSE;
+    fetchedRows      = 0;
+
+    asyncRendering    = FALSE;
+    renderPending     = FALSE;
+    renderRequested   = FALSE;
+    renderTargetReady = FALSE;
+    renderFinished    = FALSE;
+    renderThreadExit  = FALSE;
+}
+
+AY38900::~AY38900()
+{
+    setAsyncRendering(FALSE);
 }
 
 void AY38900::resetProcessor()
 {
+    //drop any frame still being rendered
+    finishAsyncFrame();
+
     //switch to bus copy mode
     setGraphicsBusVisible(TRUE);
 
+    //the GROM never changes, so keep a copy the renderer can read directly
+    for (UINT16 i = 0; i < sizeof(frameGrom); i++)
+        frameGrom[i] = (UINT8)grom->peek((UINT16)(LOCATION_GROM+i));
+
     //reset the mobs
     for (UINT8 i = 0; i < 8; i++)
         mobs[i].reset();
@@ -100,6 +129,9 @@ void AY38900::resetProcessor()
     colorStackChanged      = TRUE;
     offsetsChanged         = TRUE;
 
+    fetchedRows = 0;
+    renderForced = TRUE;
+
     //local register data
     borderColor = 0;
     blockLeft = blockTop = FALSE;
@@ -148,8 +180,16 @@ INT32 AY38900::tick(INT32 minimum) {
             if (!displayEnabled) {
                 if (previousDisplayEnabled) {
                     //render a blank screen
-                    for (int x = 0; x < 160*192; x++)
-						((UINT32*)pixelBuffer)[x] = palette[borderColor];
+                    finishAsyncFrame();
+                    int outputHeight = (halfHeightOutput ? 96 : 192);
+                    for (int y = 0; y < outputHeight; y++) {
+                        UINT32* nextPixel = ((UINT32*)pixelBuffer) + (y*pixelBufferRowSize/4);
+                        for (int x = 0; x < 160; x++)
+                            *nextPixel++ = palette[borderColor];
+                    }
+                    previousRenderTarget = pixelBuffer;
+                    frameChanged = TRUE;
+                    renderForced = TRUE;
                 }
                 previousDisplayEnabled = FALSE;
                 mode = MODE_VBLANK;
@@ -186,7 +226,8 @@ INT32 AY38900::tick(INT32 minimum) {
 
         case MODE_FETCH_ROW_0:
             pinOut[AY38900_PIN_OUT_SR2]->isHigh = FALSE;
-            //renderRow((mode-3)/2);
+            if (rowAccurate)
+                fetchRow(0);
             totalTicks += TICK_LENGTH_FETCH_ROW;
             if (totalTicks >= minimum) {
                 mode = MODE_RENDER_ROW_0;
@@ -204,7 +245,8 @@ INT32 AY38900::tick(INT32 minimum) {
 
         case MODE_FETCH_ROW_1:
             pinOut[AY38900_PIN_OUT_SR2]->isHigh = FALSE;
-            //renderRow((mode-3)/2);
+            if (rowAccurate)
+                fetchRow(1);
             totalTicks += TICK_LENGTH_FETCH_ROW;
             if (totalTicks >= minimum) {
                 mode = MODE_RENDER_ROW_1;
@@ -222,7 +264,8 @@ INT32 AY38900::tick(INT32 minimum) {
 
         case MODE_FETCH_ROW_2:
             pinOut[AY38900_PIN_OUT_SR2]->isHigh = FALSE;
-            //renderRow((mode-3)/2);
+            if (rowAccurate)
+                fetchRow(2);
             totalTicks += TICK_LENGTH_FETCH_ROW;
             if (totalTicks >= minimum) {
                 mode = MODE_RENDER_ROW_2;
@@ -240,7 +283,8 @@ INT32 AY38900::tick(INT32 minimum) {
 
         case MODE_FETCH_ROW_3:
             pinOut[AY38900_PIN_OUT_SR2]->isHigh = FALSE;
-            //renderRow((mode-3)/2);
+            if (rowAccurate)
+                fetchRow(3);
             totalTicks += TICK_LENGTH_FETCH_ROW;
             if (totalTicks >= minimum) {
                 mode = MODE_RENDER_ROW_3;
@@ -258,7 +302,8 @@ INT32 AY38900::tick(INT32 minimum) {
 
         case MODE_FETCH_ROW_4:
             pinOut[AY38900_PIN_OUT_SR2]->isHigh = FALSE;
-            //renderRow((mode-3)/2);
+            if (rowAccurate)
+                fetchRow(4);
             totalTicks += TICK_LENGTH_FETCH_ROW;
             if (totalTicks >= minimum) {
                 mode = MODE_RENDER_ROW_4;
@@ -276,7 +321,8 @@ INT32 AY38900::tick(INT32 minimum) {
 
         case MODE_FETCH_ROW_5:
             pinOut[AY38900_PIN_OUT_SR2]->isHigh = FALSE;
-            //renderRow((mode-3)/2);
+            if (rowAccurate)
+                fetchRow(5);
             totalTicks += TICK_LENGTH_FETCH_ROW;
             if (totalTicks >= minimum) {
                 mode = MODE_RENDER_ROW_5;
@@ -294,7 +340,8 @@ INT32 AY38900::tick(INT32 minimum) {
 
         case MODE_FETCH_ROW_6:
             pinOut[AY38900_PIN_OUT_SR2]->isHigh = FALSE;
-            //renderRow((mode-3)/2);
+            if (rowAccurate)
+                fetchRow(6);
             totalTicks += TICK_LENGTH_FETCH_ROW;
             if (totalTicks >= minimum) {
                 mode = MODE_RENDER_ROW_6;
@@ -312,7 +359,8 @@ INT32 AY38900::tick(INT32 minimum) {
 
         case MODE_FETCH_ROW_7:
             pinOut[AY38900_PIN_OUT_SR2]->isHigh = FALSE;
-            //renderRow((mode-3)/2);
+            if (rowAccurate)
+                fetchRow(7);
             totalTicks += TICK_LENGTH_FETCH_ROW;
             if (totalTicks >= minimum) {
                 mode = MODE_RENDER_ROW_7;
@@ -330,7 +378,8 @@ INT32 AY38900::tick(INT32 minimum) {
 
         case MODE_FETCH_ROW_8:
             pinOut[AY38900_PIN_OUT_SR2]->isHigh = FALSE;
-            //renderRow((mode-3)/2);
+            if (rowAccurate)
+                fetchRow(8);
             totalTicks += TICK_LENGTH_FETCH_ROW;
             if (totalTicks >= minimum) {
                 mode = MODE_RENDER_ROW_8;
@@ -348,7 +397,8 @@ INT32 AY38900::tick(INT32 minimum) {
 
         case MODE_FETCH_ROW_9:
             pinOut[AY38900_PIN_OUT_SR2]->isHigh = FALSE;
-            //renderRow((mode-3)/2);
+            if (rowAccurate)
+                fetchRow(9);
             totalTicks += TICK_LENGTH_FETCH_ROW;
             if (totalTicks >= minimum) {
                 mode = MODE_RENDER_ROW_9;
@@ -366,7 +416,8 @@ INT32 AY38900::tick(INT32 minimum) {
 
         case MODE_FETCH_ROW_10:
             pinOut[AY38900_PIN_OUT_SR2]->isHigh = FALSE;
-            //renderRow((mode-3)/2);
+            if (rowAccurate)
+                fetchRow(10);
             totalTicks += TICK_LENGTH_FETCH_ROW;
             if (totalTicks >= minimum) {
                 mode = MODE_RENDER_ROW_10;
@@ -384,7 +435,8 @@ INT32 AY38900::tick(INT32 minimum) {
 
         case MODE_FETCH_ROW_11:
             pinOut[AY38900_PIN_OUT_SR2]->isHigh = FALSE;
-            //renderRow((mode-3)/2);
+            if (rowAccurate)
+                fetchRow(11);
             totalTicks += TICK_LENGTH_FETCH_ROW;
             if (totalTicks >= minimum) {
                 mode = MODE_RENDER_ROW_11;
@@ -429,29 +481,286 @@ INT32 AY38900::tick(INT32 minimum) {
 
 void AY38900::setPixelBuffer(UINT32* pixelBuffer, UINT32 rowSize)
 {
+	//the render thread reads the buffer and its row size once it has been
+	//told its target is ready, so they change under the same lock
+	std::unique_lock<std::mutex> lock(renderMutex, std::defer_lock);
+	if (asyncRendering) {
+		lock.lock();
+		if (renderPending) {
+			if (!renderTargetReady) {
+				//the frame in flight goes into the buffer the video bus publishes next
+				renderTarget = pixelBuffer;
+				renderOddRows = oddRowList;
+				renderTargetReady = TRUE;
+				renderCondition.notify_all();
+			}
+			else {
+				//the frame in flight is drawing into the old buffer, which may be going away
+				while (!renderFinished)
+					renderCondition.wait(lock);
+			}
+		}
+	}
+
+	//a new set of buffers has to be drawn from scratch
+	if (AY38900::pixelBuffer == NULL)
+		renderForced = TRUE;
+	if (pixelBuffer == NULL)
+		previousRenderTarget = NULL;
+
 	AY38900::pixelBuffer = pixelBuffer;
 	AY38900::pixelBufferRowSize = rowSize;
 }
 
+void AY38900::setAsyncRendering(BOOL async)
+{
+    if (async == asyncRendering)
+        return;
+
+    if (async) {
+        renderThreadExit = FALSE;
+        asyncRendering = TRUE;
+        renderThread = std::thread(&AY38900::renderThreadMain, this);
+    }
+    else {
+        finishAsyncFrame();
+        {
+            std::lock_guard<std::mutex> lock(renderMutex);
+            renderThreadExit = TRUE;
+            renderCondition.notify_all();
+        }
+        renderThread.join();
+        asyncRendering = FALSE;
+    }
+}
+
+void AY38900::setHalfHeightOutput(BOOL halfHeight)
+{
+    halfHeightOutput = halfHeight;
+    renderForced = TRUE;
+}
+
 void AY38900::renderFrame()
 {
+    //collect the frame in flight on the render thread, if any
+    finishAsyncFrame();
+
+    //a frame with the same inputs as the last one rendered would come out
+    //identical, so only its collisions need to be posted again
+    if (!inputsChanged()) {
+        fetchedRows = 0;
+        markClean();
+        postCollisions();
+        return;
+    }
+
+    if (asyncRendering) {
+        //hand this frame to the render thread
+        captureFrame();
+
+        std::lock_guard<std::mutex> lock(renderMutex);
+        renderTarget = NULL;
+        renderOddRows = NULL;
+        renderTargetReady = FALSE;
+        renderFinished = FALSE;
+        renderPending = TRUE;
+        renderRequested = TRUE;
+        renderCondition.notify_all();
+        return;
+    }
+
     //render the next frame
+    captureFrame();
+    renderTarget = pixelBuffer;
+    renderOddRows = oddRowList;
+    renderFrameBuffers();
+    renderFramePixels();
+    postCollisions();
+    frameChanged = TRUE;
+}
+
+//check everything the renderer reads against the inputs of the last frame
+//rendered; the dirty flags catch backtab and GRAM writes, and the STIC
+//registers are compared because programs often rewrite them with the same
+//values every frame
+BOOL AY38900::inputsChanged()
+{
+    if (renderForced || colorModeChanged || backtab.isDirty() || gram->isDirty())
+        return TRUE;
+
+    //the MOB registers
+    if (memcmp(registers.memory, frameRegisters, 0x18*sizeof(UINT16)) != 0)
+        return TRUE;
+
+    //the color stack, border color, offsets and border extensions
+    if (memcmp(registers.memory+0x28, frameRegisters+0x28, 0x0B*sizeof(UINT16)) != 0)
+        return TRUE;
+
+    //a card written after its row was fetched only shows up in the next frame
+    if (rowAccurate && (fetchedRows != 0x0FFF ||
+            memcmp(fetchedBacktab, frameBacktab, sizeof(frameBacktab)) != 0))
+        return TRUE;
+
+    return FALSE;
+}
+
+//copy everything the renderer reads into the frame inputs and mark the
+//live state clean
+void AY38900::captureFrame()
+{
+    if (rowAccurate) {
+        //rows that were not fetched during this frame (only possible just after a
+        //reset or a state load) are taken from the backtab as it stands
+        for (INT32 row = 0; row < 12; row++) {
+            if ((fetchedRows & (1 << row)) == 0)
+                memcpy(fetchedBacktab + (row*20), backtab.image + (row*20), 20*sizeof(UINT16));
+        }
+        fetchedRows = 0;
+
+        //a card written after its row was fetched is marked clean at the end of
+        //this frame but only rendered in the next one, so compare against the
+        //cards that were last rendered as well as checking the dirty flags
+        frameColorAdvanceBitsDirty = backtab.areColorAdvanceBitsDirty();
+        for (INT32 i = 0; i < BACKTAB_SIZE; i++) {
+            UINT16 changedBits = (UINT16)(fetchedBacktab[i] ^ frameBacktab[i]);
+            frameBacktabDirty[i] = backtab.dirtyBytes[i] || changedBits != 0;
+            if ((changedBits & 0x2000) != 0)
+                frameColorAdvanceBitsDirty = TRUE;
+        }
+        memcpy(frameBacktab, fetchedBacktab, sizeof(frameBacktab));
+    }
+    else {
+        memcpy(frameBacktab, backtab.image, sizeof(frameBacktab));
+        memcpy(frameBacktabDirty, backtab.dirtyBytes, sizeof(frameBacktabDirty));
+        frameColorAdvanceBitsDirty = backtab.areColorAdvanceBitsDirty();
+    }
+    memcpy(frameGram, gram->image, sizeof(frameGram));
+    memcpy(frameGramCardsDirty, gram->dirtyCards, sizeof(frameGramCardsDirty));
+    for (int i = 0; i < 4; i++)
+        frameColorStack[i] = registers.memory[0x28+i];
+    memcpy(frameRegisters, registers.memory, sizeof(frameRegisters));
+    renderForced = FALSE;
+    for (int i = 0; i < 8; i++)
+        frameMobs[i] = mobs[i];
+
+    frameColorStackMode = colorStackMode;
+    frameColorModeChanged = colorModeChanged;
+    frameColorStackChanged = colorStackChanged;
+    frameBorderColor = borderColor;
+    frameBlockLeft = blockLeft;
+    frameBlockTop = blockTop;
+    frameHorizontalOffset = horizontalOffset;
+    frameVerticalOffset = verticalOffset;
+
+    markClean();
+}
+
+//latch a row of cards as the STIC fetches it from the backtab
+void AY38900::fetchRow(INT32 rowNum)
+{
+    memcpy(fetchedBacktab + (rowNum*20), backtab.image + (rowNum*20), 20*sizeof(UINT16));
+    fetchedRows |= (UINT16)(1 << rowNum);
+}
+
+void AY38900::setRowAccurate(BOOL accurate)
+{
+    rowAccurate = accurate;
+    fetchedRows = 0;
+    renderForced = TRUE;
+}
+
+//render the background and MOBs into their offscreen buffers and find all of
+//the MOB collisions; none of this touches the pixel buffer
+void AY38900::renderFrameBuffers()
+{
     renderBackground();
     renderMOBs();
     for (int i = 0; i < 8; i++)
-        mobs[i].collisionRegister = 0;
+        frameMobs[i].collisionRegister = 0;
     determineMOBCollisions();
-    markClean();
+    determineBorderAndForegroundCollisions();
+}
+
+//compose the offscreen buffers into the render target
+void AY38900::renderFramePixels()
+{
+    if (renderTarget == NULL)
+        return;
+
+    copyUncoveredPixels();
     renderBorders();
     copyBackgroundBufferToStagingArea();
+    if (halfHeightOutput)
+        findOddRows();
     copyMOBsToStagingArea();
+    previousRenderTarget = renderTarget;
+}
+
+void AY38900::postCollisions()
+{
     for (int i = 0; i < 8; i++)
-        registers.memory[0x18+i] |= mobs[i].collisionRegister;
+        registers.memory[0x18+i] |= frameMobs[i].collisionRegister;
+}
+
+//wait for the frame on the render thread, if any, and post its collisions
+void AY38900::finishAsyncFrame()
+{
+    if (!asyncRendering)
+        return;
+
+    std::unique_lock<std::mutex> lock(renderMutex);
+    if (!renderPending)
+        return;
+
+    //the video bus has not supplied a new buffer since this frame started
+    //(the emulator ran without rendering), so draw into the current one
+    if (!renderTargetReady) {
+        renderTarget = pixelBuffer;
+        renderOddRows = oddRowList;
+        renderTargetReady = TRUE;
+        renderCondition.notify_all();
+    }
+    while (!renderFinished)
+        renderCondition.wait(lock);
+    renderPending = FALSE;
+    frameChanged = TRUE;
+    lock.unlock();
+
+    postCollisions();
+}
+
+void AY38900::renderThreadMain()
+{
+    std::unique_lock<std::mutex> lock(renderMutex);
+    while (TRUE) {
+        while (!renderRequested && !renderThreadExit)
+            renderCondition.wait(lock);
+        if (renderThreadExit)
+            return;
+        renderRequested = FALSE;
+
+        //the offscreen buffers can be rendered as soon as the frame is captured
+        lock.unlock();
+        renderFrameBuffers();
+        lock.lock();
+
+        //the pixels have to wait until the video bus says where they go
+        while (!renderTargetReady)
+            renderCondition.wait(lock);
+        lock.unlock();
+        renderFramePixels();
+        lock.lock();
+
+        renderFinished = TRUE;
+        renderCondition.notify_all();
+    }
 }
 
 void AY38900::render()
 {
 	// the video bus handles the actual rendering.
+	renderedFrameChanged = frameChanged;
+	frameChanged = FALSE;
 }
 
 void AY38900::markClean() {
@@ -470,50 +779,54 @@ void AY38900::renderBorders()
 {
     /*
     //see if anything has changed to necessitate drawing the borders
-    if (!bordersChanged && (!offsetsChanged || (blockLeft && blockTop)))
+    if (!bordersChanged && (!offsetsChanged || (frameBlockLeft && frameBlockTop)))
         return;
     */
 
+    //each STIC row covers two lines of the pixel buffer unless rendering at half height
+    UINT8 lineShift = (halfHeightOutput ? 0 : 1);
+    UINT8 outputHeight = (UINT8)(96 << lineShift);
+
     //draw the top and bottom borders
-    if (blockTop) {
+    if (frameBlockTop) {
         //move the image up 4 pixels and block the top and bottom 4 rows with the border
-        for (UINT8 y = 0; y < 8; y++) {
-            UINT32* buffer0 = ((UINT32*)pixelBuffer) + (y*pixelBufferRowSize/4);
-            UINT32* buffer1 = buffer0 + (184*pixelBufferRowSize/4);
+        for (UINT8 y = 0; y < (4 << lineShift); y++) {
+            UINT32* buffer0 = ((UINT32*)renderTarget) + (y*pixelBufferRowSize/4);
+            UINT32* buffer1 = buffer0 + ((outputHeight - (4 << lineShift))*pixelBufferRowSize/4);
             for (UINT8 x = 0; x < 160; x++) {
-                *buffer0++ = palette[borderColor];
-                *buffer1++ = palette[borderColor];
+                *buffer0++ = palette[frameBorderColor];
+                *buffer1++ = palette[frameBorderColor];
             }
         }
     }
-    else if (verticalOffset != 0) {
+    else if (frameVerticalOffset != 0) {
         //block the top rows of pixels depending on the amount of vertical offset
-        UINT8 numRows = (UINT8)(verticalOffset<<1);
+        UINT8 numRows = (UINT8)(frameVerticalOffset<<lineShift);
         for (UINT8 y = 0; y < numRows; y++) {
-            UINT32* buffer0 = ((UINT32*)pixelBuffer) + (y*pixelBufferRowSize/4);
+            UINT32* buffer0 = ((UINT32*)renderTarget) + (y*pixelBufferRowSize/4);
             for (UINT8 x = 0; x < 160; x++)
-                *buffer0++ = palette[borderColor];
+                *buffer0++ = palette[frameBorderColor];
         }
     }
 
     //draw the left and right borders
-    if (blockLeft) {
+    if (frameBlockLeft) {
         //move the image to the left 4 pixels and block the left and right 4 columns with the border
-        for (UINT8 y = 0; y < 192; y++) {
-            UINT32* buffer0 = ((UINT32*)pixelBuffer) + (y*pixelBufferRowSize/4);
+        for (UINT8 y = 0; y < outputHeight; y++) {
+            UINT32* buffer0 = ((UINT32*)renderTarget) + (y*pixelBufferRowSize/4);
             UINT32* buffer1 = buffer0 + 156;
             for (UINT8 x = 0; x < 4; x++) {
-                *buffer0++ = palette[borderColor];
-                *buffer1++ = palette[borderColor];
+                *buffer0++ = palette[frameBorderColor];
+                *buffer1++ = palette[frameBorderColor];
             }
         }
     }
-    else if (horizontalOffset != 0) {
+    else if (frameHorizontalOffset != 0) {
         //block the left columns of pixels depending on the amount of horizontal offset
-        for (UINT8 y = 0; y < 192; y++) { 
-            UINT32* buffer0 = ((UINT32*)pixelBuffer) + (y*pixelBufferRowSize/4);
-            for (UINT8 x = 0; x < horizontalOffset; x++) {
-                *buffer0++ = palette[borderColor];
+        for (UINT8 y = 0; y < outputHeight; y++) {
+            UINT32* buffer0 = ((UINT32*)renderTarget) + (y*pixelBufferRowSize/4);
+            for (UINT8 x = 0; x < frameHorizontalOffset; x++) {
+                *buffer0++ = palette[frameBorderColor];
             }
         }
     }
@@ -526,30 +839,30 @@ void AY38900::renderMOBs()
         //if the mob did not change shape and it's rendering from GROM (indicating that
         //the source of its rendering could not have changed), then this MOB does not need
         //to be re-rendered into its buffer
-        if (!mobs[i].shapeChanged && mobs[i].isGrom)
+        if (!frameMobs[i].shapeChanged && frameMobs[i].isGrom)
             continue;
 
         //start at this memory location
-        UINT16 firstMemoryLocation = (UINT16)(mobs[i].isGrom
-                ? LOCATION_GROM + (mobs[i].cardNumber << 3)
-                : LOCATION_GRAM + ((mobs[i].cardNumber & 0x3F) << 3));
+        UINT16 firstMemoryLocation = (UINT16)(frameMobs[i].isGrom
+                ? LOCATION_GROM + (frameMobs[i].cardNumber << 3)
+                : LOCATION_GRAM + ((frameMobs[i].cardNumber & 0x3F) << 3));
 
         //end at this memory location
         UINT16 lastMemoryLocation = (UINT16)(firstMemoryLocation + 8);
-        if (mobs[i].doubleYResolution)
+        if (frameMobs[i].doubleYResolution)
             lastMemoryLocation += 8;
 
         //make the pixels this tall
-        int pixelHeight = (mobs[i].quadHeight ? 4 : 1) * (mobs[i].doubleHeight ? 2 : 1);
+        int pixelHeight = (frameMobs[i].quadHeight ? 4 : 1) * (frameMobs[i].doubleHeight ? 2 : 1);
 
         //start at the first line for regular vertical rendering or start at the last line
         //for vertically mirrored rendering
         int nextLine = 0;
-        if (mobs[i].verticalMirror)
-            nextLine = (pixelHeight * (mobs[i].doubleYResolution ? 15 : 7));
+        if (frameMobs[i].verticalMirror)
+            nextLine = (pixelHeight * (frameMobs[i].doubleYResolution ? 15 : 7));
         for (UINT16 j = firstMemoryLocation; j < lastMemoryLocation; j++) {
-            if (!mobs[i].shapeChanged && !gram->isCardDirty((UINT16)(j & 0x01FF))) {
-                if (mobs[i].verticalMirror)
+            if (!frameMobs[i].shapeChanged && !frameGramCardsDirty[(j & 0x01FF) >> 3]) {
+                if (frameMobs[i].verticalMirror)
                     nextLine -= pixelHeight;
                 else
                     nextLine += pixelHeight;
@@ -557,14 +870,15 @@ void AY38900::renderMOBs()
             }
 
             //get the next line of pixels
-            UINT16 nextData = (UINT16)(memoryBus->peek(j) & 0xFF);
+            UINT16 nextData = (UINT16)((j < LOCATION_GRAM ? frameGrom[j - LOCATION_GROM]
+                    : frameGram[j & 0x01FF]) & 0xFF);
 
             //reverse the pixels horizontally if necessary
-            if (mobs[i].horizontalMirror)
+            if (frameMobs[i].horizontalMirror)
                 nextData = (UINT16)((reverse[nextData & 0x0F] << 4) | reverse[(nextData & 0xF0) >> 4]);
 
             //double them if necessary
-            if (mobs[i].doubleWidth)
+            if (frameMobs[i].doubleWidth)
                 nextData = (UINT16)((stretch[(nextData & 0xF0) >> 4] << 8) | stretch[nextData & 0x0F]);
             else
                 nextData <<= 8;
@@ -573,7 +887,7 @@ void AY38900::renderMOBs()
             for (int k = 0; k < pixelHeight; k++)
                 mobBuffers[i][nextLine++] = nextData;
 
-            if (mobs[i].verticalMirror)
+            if (frameMobs[i].verticalMirror)
                 nextLine -= (2*pixelHeight);
         }
     }
@@ -586,7 +900,7 @@ void AY38900::renderBackground()
         return;
     */
 
-    if (colorStackMode)
+    if (frameColorStackMode)
         renderColorStackMode();
     else
         renderForegroundBackgroundMode();
@@ -597,22 +911,22 @@ void AY38900::renderForegroundBackgroundMode()
     //iterate through all the cards in the backtab
     for (UINT8 i = 0; i < 240; i++) {
         //get the next card to render
-        UINT16 nextCard = backtab.peek(LOCATION_BACKTAB+i);
+        UINT16 nextCard = frameBacktab[i];
         BOOL isGrom = (nextCard & 0x0800) == 0;
         UINT16 memoryLocation = nextCard & 0x01F8;
 
         //render this card only if this card has changed or if the card points to GRAM
         //and one of the eight bytes in gram that make up this card have changed
-        if (colorModeChanged || backtab.isDirty(LOCATION_BACKTAB+i) || (!isGrom && gram->isCardDirty(memoryLocation))) {
+        if (frameColorModeChanged || frameBacktabDirty[i] || (!isGrom && frameGramCardsDirty[memoryLocation>>3])) {
             UINT8 fgcolor = (UINT8)((nextCard & 0x0007) | FOREGROUND_BIT);
             UINT8 bgcolor = (UINT8)(((nextCard & 0x2000) >> 11) | ((nextCard & 0x1600) >> 9));
 
-            Memory* memory = (isGrom ? (Memory*)grom : (Memory*)gram);
-            UINT16 address = memory->getReadAddress()+memoryLocation;
             UINT8 nextx = (i%20) * 8;
             UINT8 nexty = (i/20) * 8;
-            for (UINT16 j = 0; j < 8; j++)
-                renderLine((UINT8)memory->peek(address+j), nextx, nexty+j, fgcolor, bgcolor);
+            for (UINT16 j = 0; j < 8; j++) {
+                UINT8 nextByte = (UINT8)(isGrom ? frameGrom[memoryLocation+j] : frameGram[memoryLocation+j]);
+                renderLine(nextByte, nextx, nexty+j, fgcolor, bgcolor);
+            }
         }
     }
 }
@@ -623,19 +937,19 @@ void AY38900::renderColorStackMode()
     //if there are any dirty color advance bits in the backtab, or if
     //the color stack or the color mode has changed, the whole scene
     //must be rendered
-    BOOL renderAll = backtab.areColorAdvanceBitsDirty() ||
-        colorStackChanged || colorModeChanged;
+    BOOL renderAll = frameColorAdvanceBitsDirty ||
+        frameColorStackChanged || frameColorModeChanged;
 
     UINT8 nextx = 0;
     UINT8 nexty = 0;
     //iterate through all the cards in the backtab
     for (UINT8 h = 0; h < 240; h++) {
-        UINT16 nextCard = backtab.peek(LOCATION_BACKTAB+h);
+        UINT16 nextCard = frameBacktab[h];
 
         //colored squares mode
         if ((nextCard & 0x1800) == 0x1000) {
-            if (renderAll || backtab.isDirty(LOCATION_BACKTAB+h)) {
-                UINT8 csColor = (UINT8)registers.memory[0x28 + csPtr];
+            if (renderAll || frameBacktabDirty[h]) {
+                UINT8 csColor = (UINT8)frameColorStack[csPtr];
                 UINT8 color0 = (UINT8)(nextCard & 0x0007);
                 UINT8 color1 = (UINT8)((nextCard & 0x0038) >> 3);
                 UINT8 color2 = (UINT8)((nextCard & 0x01C0) >> 6);
@@ -658,15 +972,15 @@ void AY38900::renderColorStackMode()
             UINT16 memoryLocation = (isGrom ? (nextCard & 0x07F8)
                 : (nextCard & 0x01F8));
 
-            if (renderAll || backtab.isDirty(LOCATION_BACKTAB+h) ||
-                (!isGrom && gram->isCardDirty(memoryLocation))) {
+            if (renderAll || frameBacktabDirty[h] ||
+                (!isGrom && frameGramCardsDirty[memoryLocation>>3])) {
                 UINT8 fgcolor = (UINT8)(((nextCard & 0x1000) >> 9) |
                     (nextCard & 0x0007) | FOREGROUND_BIT);
-                UINT8 bgcolor = (UINT8)registers.memory[0x28 + csPtr];
-                Memory* memory = (isGrom ? (Memory*)grom : (Memory*)gram);
-                UINT16 address = memory->getReadAddress()+memoryLocation;
-                for (UINT16 j = 0; j < 8; j++)
-                    renderLine((UINT8)memory->peek(address+j), nextx, nexty+j, fgcolor, bgcolor);
+                UINT8 bgcolor = (UINT8)frameColorStack[csPtr];
+                for (UINT16 j = 0; j < 8; j++) {
+                    UINT8 nextByte = (UINT8)(isGrom ? frameGrom[memoryLocation+j] : frameGram[memoryLocation+j]);
+                    renderLine(nextByte, nextx, nexty+j, fgcolor, bgcolor);
+                }
             }
         }
         nextx += 8;
@@ -677,19 +991,57 @@ void AY38900::renderColorStackMode()
     }
 }
 
-void AY38900::copyBackgroundBufferToStagingArea()
+//when the image is offset without blocking the edges, the background does not
+//reach the bottom rows or the right columns and those keep what was on the screen
+//before; the video bus does not carry the last frame forward, so copy them over
+void AY38900::copyUncoveredPixels()
 {
-    int sourceWidthX = blockLeft ? 152 : (160 - horizontalOffset);
-    int sourceHeightY = blockTop ? 88 : (96 - verticalOffset);
+    if (previousRenderTarget == NULL || previousRenderTarget == renderTarget)
+        return;
 
-    int nextSourcePixel = (blockLeft ? (8 - horizontalOffset) : 0) +
-	((blockTop ? (8 - verticalOffset) : 0) * 160);
+    UINT8 lineShift = (halfHeightOutput ? 0 : 1);
+    UINT8 outputHeight = (UINT8)(96 << lineShift);
+    if (!frameBlockTop && frameVerticalOffset != 0) {
+        for (UINT8 y = (UINT8)((96 - frameVerticalOffset) << lineShift); y < outputHeight; y++)
+            memcpy(renderTarget + (y*pixelBufferRowSize/4),
+                previousRenderTarget + (y*pixelBufferRowSize/4), 160 * sizeof(UINT32));
+    }
+    if (!frameBlockLeft && frameHorizontalOffset != 0) {
+        UINT8 firstX = (UINT8)(160 - frameHorizontalOffset);
+        for (UINT8 y = 0; y < outputHeight; y++)
+            memcpy(renderTarget + (y*pixelBufferRowSize/4) + firstX,
+                previousRenderTarget + (y*pixelBufferRowSize/4) + firstX,
+                frameHorizontalOffset * sizeof(UINT32));
+    }
+}
+
+void AY38900::copyBackgroundBufferToStagingArea()
+{
+    int sourceWidthX = frameBlockLeft ? 152 : (160 - frameHorizontalOffset);
+    int sourceHeightY = frameBlockTop ? 88 : (96 - frameVerticalOffset);
+
+    int nextSourcePixel = (frameBlockLeft ? (8 - frameHorizontalOffset) : 0) +
+	((frameBlockTop ? (8 - frameVerticalOffset) : 0) * 160);
+
+    if (halfHeightOutput) {
+        //write each row only once; the consumer doubles the lines if it needs to
+        for (int y = 0; y < sourceHeightY; y++) {
+            UINT32* nextPixelStore = (UINT32*)renderTarget;
+            nextPixelStore += (y*pixelBufferRowSize)>>2;
+            if (frameBlockTop) nextPixelStore += pixelBufferRowSize;
+            if (frameBlockLeft) nextPixelStore += 4;
+            for (int x = 0; x < sourceWidthX; x++)
+                *nextPixelStore++ = palette[backgroundBuffer[nextSourcePixel+x]];
+            nextSourcePixel += 160;
+        }
+        return;
+    }
 
     for (int y = 0; y < sourceHeightY; y++) {
-		UINT32* nextPixelStore0 = (UINT32*)pixelBuffer;
+		UINT32* nextPixelStore0 = (UINT32*)renderTarget;
 		nextPixelStore0 += (y*pixelBufferRowSize)>>1;
-		if (blockTop) nextPixelStore0 += pixelBufferRowSize<<1;
-		if (blockLeft) nextPixelStore0 += 4;
+		if (frameBlockTop) nextPixelStore0 += pixelBufferRowSize<<1;
+		if (frameBlockLeft) nextPixelStore0 += 4;
 		UINT32* nextPixelStore1 = nextPixelStore0 + pixelBufferRowSize/4;
         for (int x = 0; x < sourceWidthX; x++) {
 			UINT32 nextColor = palette[backgroundBuffer[nextSourcePixel+x]];
@@ -700,62 +1052,109 @@ void AY38900::copyBackgroundBufferToStagingArea()
     }
 }
 
+//a MOB moved up or left by the offsets can sit over a part of the screen the
+//background does not cover, which holds no foreground
+UINT8 AY38900::backgroundPixel(INT32 x, INT32 y)
+{
+    if (x < 0 || x >= 160 || y < 0 || y >= 96)
+        return 0;
+
+    return backgroundBuffer[x + (y*160)];
+}
+
 //copy the offscreen mob buffers to the staging area
 void AY38900::copyMOBsToStagingArea()
 {
     for (INT8 i = 7; i >= 0; i--) {
-        if (mobs[i].xLocation == 0 || (!mobs[i].flagCollisions && !mobs[i].isVisible))
+        if (frameMobs[i].xLocation == 0 || !frameMobs[i].isVisible)
             continue;
 
-        BOOL borderCollision = FALSE;
-        BOOL foregroundCollision = FALSE;
 
-        MOBRect* r = mobs[i].getBounds();
+        MOBRect* r = frameMobs[i].getBounds();
         UINT8 mobPixelHeight = (UINT8)(r->height << 1);
-        UINT8 fgcolor = (UINT8)mobs[i].foregroundColor;
+        UINT8 fgcolor = (UINT8)frameMobs[i].foregroundColor;
 
-        INT16 leftX = (INT16)(r->x + horizontalOffset);
-        INT16 nextY = (INT16)((r->y + verticalOffset) << 1);
+        INT16 leftX = (INT16)(r->x + frameHorizontalOffset);
+        INT16 nextY = (INT16)((r->y + frameVerticalOffset) * 2);
         for (UINT8 y = 0; y < mobPixelHeight; y++) {
             for (UINT8 x = 0; x < r->width; x++) {
                 //if this mob pixel is not on, then our life has no meaning
                 if ((mobBuffers[i][y] & (0x8000 >> x)) == 0)
                     continue;
 
-                //if the next pixel location is on the border, then we
-                //have a border collision and we can ignore painting it
+                //pixels on the border are not painted
                 int nextX = leftX + x;
-                if (nextX < (blockLeft ? 8 : 0) || nextX > 158 ||
-                        nextY < (blockTop ? 16 : 0) || nextY > 191) {
-                    borderCollision = TRUE;
+                if (nextX < (frameBlockLeft ? 8 : 0) || nextX > 158 ||
+                        nextY < (frameBlockTop ? 16 : 0) || nextY > 191)
                     continue;
-                }
 
-                //check for foreground collision
-                UINT8 currentPixel = backgroundBuffer[(r->x+x)+ ((r->y+(y/2))*160)];
-                if ((currentPixel & FOREGROUND_BIT) != 0) {
-                    foregroundCollision = TRUE;
-                    if (mobs[i].behindForeground)
+                UINT8 currentPixel = backgroundPixel(r->x+x, r->y+(y/2));
+                if ((currentPixel & FOREGROUND_BIT) != 0 && frameMobs[i].behindForeground)
+                    continue;
+
+                UINT32* nextPixel;
+                if (halfHeightOutput) {
+                    //odd lines only need to be written if they differ from the even line
+                    INT32 row = (nextY - (frameBlockTop ? 8 : 0)) >> 1;
+                    if ((nextY & 1) == 0)
+                        nextPixel = (UINT32*)renderTarget + (row * (pixelBufferRowSize/4));
+                    else if (oddRowIndex[row] != -1)
+                        nextPixel = renderOddRows->pixels + (oddRowIndex[row] * 160);
+                    else
                         continue;
                 }
-                if (mobs[i].isVisible) {
-					UINT32* nextPixel = (UINT32*)pixelBuffer;
-					nextPixel += leftX - (blockLeft ? 4 : 0) + x;
-					nextPixel += (nextY - (blockTop ? 8 : 0)) * (pixelBufferRowSize/4);
-					*nextPixel = palette[fgcolor | (currentPixel & FOREGROUND_BIT)];
+                else {
+                    nextPixel = (UINT32*)renderTarget;
+                    nextPixel += (nextY - (frameBlockTop ? 8 : 0)) * (pixelBufferRowSize/4);
                 }
+                nextPixel += leftX - (frameBlockLeft ? 4 : 0) + x;
+                *nextPixel = palette[fgcolor | (currentPixel & FOREGROUND_BIT)];
             }
             nextY++;
         }
+    }
+}
 
-        //update the collision bits
-        if (mobs[i].flagCollisions) {
-            if (foregroundCollision)
-                mobs[i].collisionRegister |= 0x0100;
-            if (borderCollision)
-                mobs[i].collisionRegister |= 0x0200;
+//find the rows of a half-height frame whose odd line will differ from the even
+//line, and seed their odd lines with the background and borders already rendered;
+//the list goes into the frame data the video bus keeps with the render target
+void AY38900::findOddRows()
+{
+    memset(oddRowIndex, -1, sizeof(oddRowIndex));
+    if (renderOddRows == NULL)
+        return;
+
+    BOOL oddRowFlags[96] = { FALSE };
+
+    for (INT8 i = 7; i >= 0; i--) {
+        if (frameMobs[i].xLocation == 0 || !frameMobs[i].isVisible)
+            continue;
+
+        MOBRect* r = frameMobs[i].getBounds();
+        INT16 firstLine = (INT16)(((r->y + frameVerticalOffset) * 2) - (frameBlockTop ? 8 : 0));
+        INT16 lastLine = (INT16)(frameBlockTop ? 183 : 191);
+        for (UINT8 y = 0; y < r->height; y++) {
+            INT16 nextLine = (INT16)(firstLine + (y << 1));
+            if (nextLine < 0 || nextLine > lastLine)
+                continue;
+            if (mobBuffers[i][y << 1] != mobBuffers[i][(y << 1) + 1])
+                oddRowFlags[nextLine >> 1] = TRUE;
         }
     }
+
+    UINT32 oddRowCount = 0;
+    for (UINT8 row = 0; row < 96; row++) {
+        if (!oddRowFlags[row])
+            continue;
+
+        oddRowIndex[row] = (INT8)oddRowCount;
+        renderOddRows->rows[oddRowCount] = row;
+        memcpy(renderOddRows->pixels + (oddRowCount * 160),
+            ((UINT32*)renderTarget) + (row * (pixelBufferRowSize/4)),
+            160 * sizeof(UINT32));
+        oddRowCount++;
+    }
+    renderOddRows->count = oddRowCount;
 }
 
 void AY38900::renderLine(UINT8 nextbyte, int x, int y, UINT8 fgcolor, UINT8 bgcolor)
@@ -792,30 +1191,69 @@ void AY38900::renderColoredSquares(int x, int y, UINT8 color0, UINT8 color1,
     }
 }
 
+//find the MOB on border and MOB on foreground collisions from the offscreen
+//buffers, so that they are posted whether or not a frame is being drawn
+void AY38900::determineBorderAndForegroundCollisions()
+{
+    for (INT8 i = 7; i >= 0; i--) {
+        if (frameMobs[i].xLocation == 0 || !frameMobs[i].flagCollisions)
+            continue;
+
+        BOOL borderCollision = FALSE;
+        BOOL foregroundCollision = FALSE;
+        MOBRect* r = frameMobs[i].getBounds();
+        UINT8 mobPixelHeight = (UINT8)(r->height << 1);
+
+        INT16 leftX = (INT16)(r->x + frameHorizontalOffset);
+        INT16 nextY = (INT16)((r->y + frameVerticalOffset) * 2);
+        for (UINT8 y = 0; y < mobPixelHeight; y++) {
+            for (UINT8 x = 0; x < r->width; x++) {
+                if ((mobBuffers[i][y] & (0x8000 >> x)) == 0)
+                    continue;
+
+                //a pixel on the border collides with the border, and only a
+                //pixel inside it can collide with the foreground
+                int nextX = leftX + x;
+                if (nextX < (frameBlockLeft ? 8 : 0) || nextX > 158 ||
+                        nextY < (frameBlockTop ? 16 : 0) || nextY > 191)
+                    borderCollision = TRUE;
+                else if ((backgroundPixel(r->x+x, r->y+(y/2)) & FOREGROUND_BIT) != 0)
+                    foregroundCollision = TRUE;
+            }
+            nextY++;
+        }
+
+        if (foregroundCollision)
+            frameMobs[i].collisionRegister |= 0x0100;
+        if (borderCollision)
+            frameMobs[i].collisionRegister |= 0x0200;
+    }
+}
+
 void AY38900::determineMOBCollisions()
 {
     for (int i = 0; i < 7; i++) {
-        if (mobs[i].xLocation == 0 || !mobs[i].flagCollisions)
+        if (frameMobs[i].xLocation == 0 || !frameMobs[i].flagCollisions)
             continue;
 
         /*
         //check MOB on foreground collisions
         if (mobCollidesWithForeground(i))
-            mobs[i].collisionRegister |= 0x0100;
+            frameMobs[i].collisionRegister |= 0x0100;
 
         //check MOB on border collisions
         if (mobCollidesWithBorder(i))
-            mobs[i].collisionRegister |= 0x0200;
+            frameMobs[i].collisionRegister |= 0x0200;
         */
 
         //check MOB on MOB collisions
         for (int j = i+1; j < 8; j++) {
-            if (mobs[j].xLocation == 0 || !mobs[j].flagCollisions)
+            if (frameMobs[j].xLocation == 0 || !frameMobs[j].flagCollisions)
                 continue;
 
             if (mobsCollide(i, j)) {
-                mobs[i].collisionRegister |= (1 << j);
-                mobs[j].collisionRegister |= (1 << i);
+                frameMobs[i].collisionRegister |= (1 << j);
+                frameMobs[j].collisionRegister |= (1 << i);
             }
         }
     }
@@ -823,19 +1261,19 @@ void AY38900::determineMOBCollisions()
 
 BOOL AY38900::mobCollidesWithBorder(int mobNum)
 {
-    MOBRect* r = mobs[mobNum].getBounds();
+    MOBRect* r = frameMobs[mobNum].getBounds();
     UINT8 mobPixelHeight = (UINT8)(r->height<<1);
 
     /*
-    if (r->x > (blockLeft ? 8 : 0) && r->x+r->width <= 191 &&
-            r->y > (blockTop ? 8 : 0) && r->y+r->height <= 158)
+    if (r->x > (frameBlockLeft ? 8 : 0) && r->x+r->width <= 191 &&
+            r->y > (frameBlockTop ? 8 : 0) && r->y+r->height <= 158)
         return FALSE;
 
     for (UINT8 i = 0; i < r->height; i++) {
         if (mobBuffers[mobNum][i<<1] == 0 || mobBuffers[mobNum][(i<<1)+1] == 0)
             continue;
 
-        if (r->y+i < (blockLeft ? 8 : 0) || r->y+r->height+i > 158)
+        if (r->y+i < (frameBlockLeft ? 8 : 0) || r->y+r->height+i > 158)
             return TRUE;
 
         //if (r->x && border
@@ -844,8 +1282,8 @@ BOOL AY38900::mobCollidesWithBorder(int mobNum)
 
     UINT16 leftRightBorder = 0;
     //check if could possibly touch the left border
-    if (r->x < (blockLeft ? 8 : 0)) {
-        leftRightBorder = (UINT16)((blockLeft ? 0xFFFF : 0xFF00) << mobs[mobNum].xLocation);
+    if (r->x < (frameBlockLeft ? 8 : 0)) {
+        leftRightBorder = (UINT16)((frameBlockLeft ? 0xFFFF : 0xFF00) << frameMobs[mobNum].xLocation);
     }
     //check if could possibly touch the right border
     else if (r->x+r->width > 158) {
@@ -865,10 +1303,10 @@ BOOL AY38900::mobCollidesWithBorder(int mobNum)
     //check if touching the top border
     UINT8 overlappingStart = 0;
     UINT8 overlappingHeight = 0;
-    if (r->y < (blockTop ? 8 : 0)) {
+    if (r->y < (frameBlockTop ? 8 : 0)) {
         overlappingHeight = mobPixelHeight;
-        if (r->y+r->height > (blockTop ? 8 : 0))
-            overlappingHeight = (UINT8)(mobPixelHeight - (2*(r->y+r->height-(blockTop ? 8 : 0))));
+        if (r->y+r->height > (frameBlockTop ? 8 : 0))
+            overlappingHeight = (UINT8)(mobPixelHeight - (2*(r->y+r->height-(frameBlockTop ? 8 : 0))));
     }
     //check if touching the bottom border
     else if (r->y+r->height > 191) {
@@ -889,8 +1327,8 @@ BOOL AY38900::mobCollidesWithBorder(int mobNum)
 
 BOOL AY38900::mobsCollide(int mobNum0, int mobNum1)
 {
-    MOBRect* r0 = mobs[mobNum0].getBounds();
-    MOBRect* r1 = mobs[mobNum1].getBounds();
+    MOBRect* r0 = frameMobs[mobNum0].getBounds();
+    MOBRect* r1 = frameMobs[mobNum1].getBounds();
     if (!r0->intersects(r1))
         return FALSE;
 
@@ -942,6 +1380,9 @@ AY38900State AY38900::getState()
 
 void AY38900::setState(AY38900State state)
 {
+	finishAsyncFrame();
+	renderForced = TRUE;
+
 	this->registers.setMemory(state.registers, 0, this->registers.getMemoryByteSize());
 	this->backtab.setState(state.backtab, state.backtab.image);
 
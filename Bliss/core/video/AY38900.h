@@ -2,6 +2,9 @@
 #ifndef AY38900_H
 #define AY38900_H
 
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "core/cpu/Processor.h"
 #include "core/memory/MemoryBus.h"
 #include "core/memory/ROM.h"
@@ -33,6 +36,19 @@ TYPEDEF_STRUCT_PACK( _AY38900State
     UINT8           _pad[1];
 } AY38900State; )
 
+/**
+ * The rows of a half-height frame whose odd line differs from the even line
+ * written to the pixel buffer, kept by the video bus with the frame.
+ */
+typedef struct _AY38900OddRows
+{
+    UINT32  count;
+    //the indices of the rows, in ascending order
+    UINT8   rows[96];
+    //the odd lines of the rows, 160 pixels per line, in the same order
+    UINT32  pixels[96*160];
+} AY38900OddRows;
+
 class AY38900 : public Processor, public VideoProducer
 {
 
@@ -40,6 +56,7 @@ class AY38900 : public Processor, public VideoProducer
 
 public:
 	AY38900(MemoryBus* mb, ROM* go, GRAM* ga);
+	virtual ~AY38900();
 
     /**
      * Implemented from the Processor interface.
@@ -68,6 +85,56 @@ public:
      */
     void render();
 
+    /**
+     * Implemented from the VideoProducer interface.  A frame whose inputs
+     * (backtab, GRAM, STIC registers and color mode) are identical to those
+     * of the last frame rendered is not rendered again, so this is FALSE
+     * while the screen is static.
+     */
+    BOOL hasFrameChanged() { return renderedFrameChanged; }
+
+    /**
+     * Selects between the full 160x192 output, in which every STIC row is
+     * written to two consecutive lines of the pixel buffer, and the native
+     * 160x96 output, in which every row is written only once.  In the
+     * half-height mode the pixel buffer need only be 96 rows tall, and the
+     * few rows whose odd line differs from the even line (which only MOBs
+     * can cause) are listed in an AY38900OddRows that the video bus keeps
+     * with the frame, so that the consumer can reconstruct the full frame.
+     * The consumer finds the list with VideoBus::getFrameData().
+     */
+    void setHalfHeightOutput(BOOL halfHeight);
+    BOOL isHalfHeightOutput() { return halfHeightOutput; }
+
+    /**
+     * Implemented from the VideoProducer interface.
+     */
+    UINT32 getFrameDataSize() { return sizeof(AY38900OddRows); }
+    void setFrameData(void* frameData) { oddRowList = (AY38900OddRows*)frameData; }
+
+    /**
+     * Enables or disables rendering on a worker thread.  When enabled, the
+     * inputs to the renderer are captured at the start of vertical blank and
+     * the frame is rendered while the CPU emulates the next one; the frame
+     * is complete, and is handed to the video bus, one frame later than in
+     * synchronous mode.  The MOB collision bits found while rendering a frame
+     * are likewise posted to the collision registers at the following
+     * vertical blank, one frame later than in synchronous mode.
+     */
+    void setAsyncRendering(BOOL async);
+    BOOL isAsyncRendering() { return asyncRendering; }
+
+    /**
+     * Enables or disables row accurate rendering.  The STIC fetches each row
+     * of cards from the backtab just before displaying it, so a program that
+     * rewrites the backtab while the frame is being displayed sees rows above
+     * the beam keep their old cards.  When enabled, each row of the backtab
+     * is latched at its fetch and the frame is rendered from the latched
+     * rows rather than from the backtab as it stands at vertical blank.
+     */
+    void setRowAccurate(BOOL accurate);
+    BOOL isRowAccurate() { return rowAccurate; }
+
 	AY38900State getState();
 	void setState(AY38900State state);
 
@@ -78,6 +145,14 @@ public:
 private:
 	void setGraphicsBusVisible(BOOL visible);
 	void renderFrame();
+	BOOL inputsChanged();
+	void captureFrame();
+	void fetchRow(INT32 rowNum);
+	void renderFrameBuffers();
+	void renderFramePixels();
+	void postCollisions();
+	void finishAsyncFrame();
+	void renderThreadMain();
 	BOOL somethingChanged();
 	void markClean();
 	void renderBorders();
@@ -85,11 +160,15 @@ private:
 	void renderBackground();
 	void renderForegroundBackgroundMode();
 	void renderColorStackMode();
+	void copyUncoveredPixels();
 	void copyBackgroundBufferToStagingArea();
+	UINT8 backgroundPixel(INT32 x, INT32 y);
 	void copyMOBsToStagingArea();
+	void findOddRows();
 	void renderLine(UINT8 nextByte, INT32 x, INT32 y, UINT8 fgcolor, UINT8 bgcolor);
 	void renderColoredSquares(INT32 x, INT32 y, UINT8 color0, UINT8 color1, UINT8 color2, UINT8 color3);
 	void determineMOBCollisions();
+	void determineBorderAndForegroundCollisions();
 	BOOL mobsCollide(INT32 mobNum0, INT32 mobNum1);
     BOOL mobCollidesWithBorder(int mobNum);
     BOOL mobCollidesWithForeground(int mobNum);
@@ -119,6 +198,57 @@ private:
     UINT32*         pixelBuffer;
     UINT32          pixelBufferRowSize;
 
+    //the inputs to the renderer, captured at the start of vertical blank so
+    //that the frame can be rendered while the live state moves on
+    UINT16          frameBacktab[BACKTAB_SIZE];
+    BOOL            frameBacktabDirty[BACKTAB_SIZE];
+    BOOL            frameColorAdvanceBitsDirty;
+    UINT16          frameGram[GRAM_SIZE];
+    BOOL            frameGramCardsDirty[GRAM_SIZE>>3];
+    UINT8           frameGrom[0x800];
+    UINT16          frameColorStack[4];
+    UINT16          frameRegisters[0x40];
+    MOB             frameMobs[8];
+    BOOL            frameColorStackMode;
+    BOOL            frameColorModeChanged;
+    BOOL            frameColorStackChanged;
+    UINT8           frameBorderColor;
+    BOOL            frameBlockLeft;
+    BOOL            frameBlockTop;
+    INT32           frameHorizontalOffset;
+    INT32           frameVerticalOffset;
+    UINT32*         renderTarget;
+    AY38900OddRows* renderOddRows;
+    //the buffer the last frame was composed into, which the video bus keeps
+    //until another frame is published
+    UINT32*         previousRenderTarget;
+
+    //frame memoisation
+    BOOL            renderForced;
+    BOOL            frameChanged;
+    BOOL            renderedFrameChanged;
+
+    //row accurate rendering
+    BOOL            rowAccurate;
+    UINT16          fetchedBacktab[BACKTAB_SIZE];
+    UINT16          fetchedRows;
+
+    //asynchronous rendering
+    BOOL                     asyncRendering;
+    std::thread              renderThread;
+    std::mutex               renderMutex;
+    std::condition_variable  renderCondition;
+    BOOL                     renderPending;
+    BOOL                     renderRequested;
+    BOOL                     renderTargetReady;
+    BOOL                     renderFinished;
+    BOOL                     renderThreadExit;
+
+    //half-height output
+    BOOL            halfHeightOutput;
+    AY38900OddRows* oddRowList;
+    INT8            oddRowIndex[96];
+
     //memory listeners, for optimizations
     ROM*            grom;
     GRAM*           gram;
@@ -3,8 +3,24 @@
 #include "core/cpu/ProcessorBus.h"
 #include <time.h>
 #include <stdlib.h> // jeremiah sypult - srand
+#include <string.h>
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define PRESENT_AVX2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PRESENT_NEON
+#endif
 
 #define IMAGE_BANK_LENGTH 76800
+#define IMAGE_BANK_WIDTH  320
+#define IMAGE_BANK_HEIGHT 240
+#define BORDER_WIDTH      8
+
+//replicates a color across all eight bytes of a word
+#define SPLAT(c)           ((UINT64)(c) * 0x0101010101010101ULL)
+//writes eight pixels at once; memcpy keeps the store safe when unaligned
+#define STORE64(p, v)      { UINT64 _v = (v); memcpy((p), &_v, 8); }
         
 const UINT8 Antic::ANBK  = 0x0;
 const UINT8 Antic::ANPF0 = 0x4;
@@ -13,6 +29,10 @@ const UINT8 Antic::ANPF2 = 0x6;
 const UINT8 Antic::ANPF3 = 0x7;
 const UINT8 Antic::AN_SPECIAL = 0x1;
 
+const UINT8 Antic::PM_DMA_CYCLES[4] = { 0, 2, 10, 10 };
+const UINT8 Antic::REFRESH_DMA_CYCLES = 18;
+UINT8 Antic::DMA_CYCLES[2][16][4];
+
 const UINT8 Antic::BLOCK_HEIGHTS[14] = { 8, 10, 8, 8, 8, 16, 8, 4, 4, 2, 1, 2, 1, 1 };
 
 const UINT8 Antic::BYTE_WIDTHS[14][4] = {
@@ -33,6 +53,13 @@ const UINT8 Antic::BYTE_WIDTHS[14][4] = {
         { 1, 32, 40, 48 },
         { 1, 32, 40, 48 } };
 
+UINT64 Antic::EXPAND_1BPP[256];
+UINT64 Antic::EXPAND_1BPP_WIDE[256][2];
+UINT64 Antic::EXPAND_2BPP_WIDE[256][4];
+UINT64 Antic::EXPAND_NIBBLES[256];
+UINT8 Antic::WIDEN_1BPP[16];
+UINT8 Antic::WIDEN_2BPP[16];
+
 const UINT32 Antic::palette[256] = {
     0x323132, 0x3f3e3f, 0x4d4c4d, 0x5b5b5b, 0x6a696a, 0x797879, 0x888788, 0x979797,
     0xa1a0a1, 0xafafaf, 0xbebebe, 0xcecdce, 0xdbdbdb, 0xebeaeb, 0xfafafa, 0xffffff,
@@ -72,10 +99,17 @@ Antic::Antic(MemoryBus* mb, GTIA* gt)
 : Processor("ANTIC"),
   memoryBus(mb),
   gtia(gt),
-  anticMode(START_HSYNC)
+  anticMode(START_HSYNC),
+  pixelBuffer(NULL),
+  pixelBufferRowSize(0),
+  watchedRAM(NULL),
+  recordingEntry(NULL)
 {
     registers.init(this);
     this->imageBank = gtia->imageBank;
+    initExpansionTables();
+    initDMATables();
+    memset(borderColors, 0, sizeof(borderColors));
 }
            
 void Antic::resetProcessor()
@@ -104,11 +138,87 @@ void Antic::resetProcessor()
     NMIST = 0;
     
     anticMode = VBLANK;
+    afterCycleStealingMode = VBLANK;
     cyclesToSteal = 0;
+    lineCyclesToSteal = 0;
+
+    invalidateSchedule();
 
     srand((unsigned int)time(NULL));
 }
 
+void Antic::setWatchedRAM(WatchedRAM* ram)
+{
+    watchedRAM = ram;
+    invalidateSchedule();
+}
+
+AnticState Antic::getState()
+{
+    AnticState state = {0};
+
+    memcpy(state.SHIFT, this->SHIFT, sizeof(this->SHIFT));
+    state.MEMSCAN = this->MEMSCAN;
+    state.DLIST = this->DLIST;
+    state.VCOUNT = this->VCOUNT;
+    state.cyclesToSteal = this->cyclesToSteal;
+    state.anticMode = this->anticMode;
+    state.afterCycleStealingMode = this->afterCycleStealingMode;
+    state.INST = this->INST;
+    state.LCOUNT = this->LCOUNT;
+    state.HCOUNT = this->HCOUNT;
+    state.MODE = this->MODE;
+    state.BYTEWIDTH = this->BYTEWIDTH;
+    state.BLOCKLENGTH = this->BLOCKLENGTH;
+    state.DMACTL = this->DMACTL;
+    state.CHACTL = this->CHACTL;
+    state.HSCROL = this->HSCROL;
+    state.VSCROL = this->VSCROL;
+    state.PMBASE = this->PMBASE;
+    state.CHBASE = this->CHBASE;
+    state.NMIEN = this->NMIEN;
+    state.NMIST = this->NMIST;
+    state.lineCyclesToSteal = this->lineCyclesToSteal;
+
+    return state;
+}
+
+void Antic::setState(AnticState state)
+{
+    memcpy(this->SHIFT, state.SHIFT, sizeof(this->SHIFT));
+    this->MEMSCAN = state.MEMSCAN;
+    this->DLIST = state.DLIST;
+    this->VCOUNT = state.VCOUNT;
+    this->cyclesToSteal = state.cyclesToSteal;
+    this->anticMode = (AnticMode)state.anticMode;
+    this->afterCycleStealingMode = (AnticMode)state.afterCycleStealingMode;
+    this->INST = state.INST;
+    this->LCOUNT = state.LCOUNT;
+    this->HCOUNT = state.HCOUNT;
+    this->MODE = state.MODE;
+    this->BYTEWIDTH = state.BYTEWIDTH;
+    this->BLOCKLENGTH = state.BLOCKLENGTH;
+    this->DMACTL = state.DMACTL;
+    this->CHACTL = state.CHACTL;
+    this->HSCROL = state.HSCROL;
+    this->VSCROL = state.VSCROL;
+    this->PMBASE = state.PMBASE;
+    this->CHBASE = state.CHBASE;
+    this->NMIEN = state.NMIEN;
+    this->NMIST = state.NMIST;
+    this->lineCyclesToSteal = state.lineCyclesToSteal;
+
+    //the compiled display list may not match the restored memory
+    invalidateSchedule();
+}
+
+void Antic::invalidateSchedule()
+{
+    for (UINT32 i = 0; i < DISPLAY_LIST_SCHEDULE_SIZE; i++)
+        schedule[i].valid = FALSE;
+    scheduleIndex = 0;
+}
+
 void Antic::setPixelBuffer(UINT32* pixelBuffer, UINT32 rowSize)
 {
 	Antic::pixelBuffer = pixelBuffer;
@@ -117,7 +227,169 @@ void Antic::setPixelBuffer(UINT32* pixelBuffer, UINT32 rowSize)
 
 void Antic::render()
 {
-	// the video bus handles rendering.
+	// the frame is presented at the start of vertical blank, see present().
+}
+
+//the palette is not separable by nibble, so a table-per-byte lookup unrolled
+//four wide is the fastest portable conversion
+static void presentPixels(const UINT8* source, UINT32* nextPixel, const UINT32* palette)
+{
+    for (UINT32 x = 0; x < IMAGE_BANK_WIDTH; x += 4) {
+        UINT32 c0 = palette[source[x]];
+        UINT32 c1 = palette[source[x+1]];
+        UINT32 c2 = palette[source[x+2]];
+        UINT32 c3 = palette[source[x+3]];
+        nextPixel[x] = c0;
+        nextPixel[x+1] = c1;
+        nextPixel[x+2] = c2;
+        nextPixel[x+3] = c3;
+    }
+}
+
+#if defined(PRESENT_AVX2)
+//eight palette lookups per gather, widening the indices from bytes; built for
+//AVX2 on its own so that the rest of the file runs on any x86 processor
+__attribute__((target("avx2")))
+static void presentPixelsAVX2(const UINT8* source, UINT32* nextPixel, const UINT32* palette)
+{
+    for (UINT32 x = 0; x < IMAGE_BANK_WIDTH; x += 8) {
+        __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(source+x)));
+        __m256i colors = _mm256_i32gather_epi32((const int*)palette, indices, 4);
+        _mm256_storeu_si256((__m256i*)(nextPixel+x), colors);
+    }
+}
+#elif defined(PRESENT_NEON)
+//the blue, green and red bytes of each palette entry, one plane per byte
+static UINT8 PALETTE_PLANES[3][256];
+
+static void initPalettePlanes(const UINT32* palette)
+{
+    static BOOL initialized = FALSE;
+    if (initialized)
+        return;
+
+    for (INT32 i = 0; i < 256; i++) {
+        PALETTE_PLANES[0][i] = (UINT8)palette[i];
+        PALETTE_PLANES[1][i] = (UINT8)(palette[i] >> 8);
+        PALETTE_PLANES[2][i] = (UINT8)(palette[i] >> 16);
+    }
+
+    initialized = TRUE;
+}
+
+//sixteen lookups per instruction from a 64 byte table, so each plane takes four
+//lookups per sixteen pixels; the planes are then interleaved into pixels, with
+//the top byte of each pixel left clear as in the palette
+static void presentPixelsNEON(const UINT8* source, UINT32* nextPixel)
+{
+    UINT8 planes[3][IMAGE_BANK_WIDTH];
+    uint8x16_t offset = vdupq_n_u8(64);
+    for (INT32 p = 0; p < 3; p++) {
+        uint8x16x4_t table0 = vld1q_u8_x4(PALETTE_PLANES[p]);
+        uint8x16x4_t table1 = vld1q_u8_x4(PALETTE_PLANES[p]+64);
+        uint8x16x4_t table2 = vld1q_u8_x4(PALETTE_PLANES[p]+128);
+        uint8x16x4_t table3 = vld1q_u8_x4(PALETTE_PLANES[p]+192);
+        for (UINT32 x = 0; x < IMAGE_BANK_WIDTH; x += 16) {
+            //an index past the end of a table leaves the lane as it was
+            uint8x16_t indices = vld1q_u8(source+x);
+            uint8x16_t bytes = vqtbl4q_u8(table0, indices);
+            indices = vsubq_u8(indices, offset);
+            bytes = vqtbx4q_u8(bytes, table1, indices);
+            indices = vsubq_u8(indices, offset);
+            bytes = vqtbx4q_u8(bytes, table2, indices);
+            indices = vsubq_u8(indices, offset);
+            bytes = vqtbx4q_u8(bytes, table3, indices);
+            vst1q_u8(planes[p]+x, bytes);
+        }
+    }
+
+    uint8x16x4_t pixels;
+    pixels.val[3] = vdupq_n_u8(0);
+    for (UINT32 x = 0; x < IMAGE_BANK_WIDTH; x += 16) {
+        pixels.val[0] = vld1q_u8(planes[0]+x);
+        pixels.val[1] = vld1q_u8(planes[1]+x);
+        pixels.val[2] = vld1q_u8(planes[2]+x);
+        vst4q_u8((UINT8*)(nextPixel+x), pixels);
+    }
+}
+#endif
+
+void Antic::present()
+{
+    if (!pixelBuffer)
+        return;
+
+#if defined(PRESENT_AVX2)
+    static const BOOL hasAVX2 = __builtin_cpu_supports("avx2") != 0;
+#elif defined(PRESENT_NEON)
+    initPalettePlanes(palette);
+#endif
+
+    const UINT8* source = imageBank;
+    for (UINT32 y = 0; y < IMAGE_BANK_HEIGHT; y++) {
+        UINT32* nextPixel = (UINT32*)(((UINT8*)pixelBuffer) + (y*pixelBufferRowSize));
+
+        //left border
+        UINT32 border = palette[borderColors[y]];
+        for (UINT32 x = 0; x < BORDER_WIDTH; x++)
+            nextPixel[x] = border;
+        nextPixel += BORDER_WIDTH;
+
+#if defined(PRESENT_AVX2)
+        if (hasAVX2)
+            presentPixelsAVX2(source, nextPixel, palette);
+        else
+            presentPixels(source, nextPixel, palette);
+#elif defined(PRESENT_NEON)
+        presentPixelsNEON(source, nextPixel);
+#else
+        presentPixels(source, nextPixel, palette);
+#endif
+        nextPixel += IMAGE_BANK_WIDTH;
+        source += IMAGE_BANK_WIDTH;
+
+        //right border
+        for (UINT32 x = 0; x < BORDER_WIDTH; x++)
+            nextPixel[x] = border;
+    }
+}
+
+void Antic::initDMATables()
+{
+    static BOOL initialized = FALSE;
+    if (initialized)
+        return;
+
+    //two color clocks per stolen cpu cycle
+    memset(DMA_CYCLES, 0, sizeof(DMA_CYCLES));
+    for (INT32 mode = 2; mode < 16; mode++) {
+        for (INT32 width = 1; width < 4; width++) {
+            UINT8 bytes = BYTE_WIDTHS[mode-2][width];
+            if (mode < 8) {
+                //character modes fetch the character names on the first line
+                //of the block and a byte of character data on every line
+                DMA_CYCLES[1][mode][width] = (UINT8)(4 * bytes);
+                DMA_CYCLES[0][mode][width] = (UINT8)(2 * bytes);
+            }
+            else {
+                //map modes fetch the screen data on the first line only
+                DMA_CYCLES[1][mode][width] = (UINT8)(2 * bytes);
+                DMA_CYCLES[0][mode][width] = 0;
+            }
+        }
+    }
+
+    initialized = TRUE;
+}
+
+UINT8 Antic::advanceTo(UINT8 hclock)
+{
+    //the stolen cycles may already have carried the line past this point
+    if (HCOUNT >= hclock)
+        return 0;
+    UINT8 clocks = (UINT8)(hclock - HCOUNT);
+    HCOUNT = hclock;
+    return clocks;
 }
 
 INT32 Antic::tick(INT32 minimum)
@@ -125,18 +397,26 @@ INT32 Antic::tick(INT32 minimum)
     INT32 usedCycles = 0;
     do {
 
+    //hold the cpu off the bus for all of the dma of this line at once
+    if (lineCyclesToSteal && HCOUNT == 0 && anticMode != START_VBLANK) {
+        pinOut[ANTIC_PIN_OUT_HALT]->isHigh = FALSE;
+        usedCycles += advanceTo(lineCyclesToSteal);
+        lineCyclesToSteal = 0;
+        afterCycleStealingMode = anticMode;
+        anticMode = END_CYCLE_STEALING;
+        continue;
+    }
+
     switch (anticMode) {
 
         case START_HSYNC:  //hclock == 0
-            HCOUNT = 16;
             anticMode = END_HSYNC;
-            usedCycles += 16;
+            usedCycles += advanceTo(16);
             break;
 
         case END_HSYNC:  //hclock == 16
-            HCOUNT = 34;
             anticMode = START_DISPLAY;
-            usedCycles += 18;
+            usedCycles += advanceTo(34);
             break;
 
         case START_DISPLAY:  //hclock == 34; vclock >= 8 && vclock < 248
@@ -146,26 +426,22 @@ INT32 Antic::tick(INT32 minimum)
                     //no instruction DMA; blank line
                     renderLine();
                     anticMode = END_WSYNC;
-                    HCOUNT = 208;
-                    usedCycles += 174;
+                    usedCycles += advanceTo(208);
                     break;
                 case 0x01:
                     //narrow playfield
                     anticMode = START_NARROW_PLAYFIELD;
-                    HCOUNT = 64;
-                    usedCycles += 30;
+                    usedCycles += advanceTo(64);
                     break;
                 case 0x02:
                     //regular playfield
                     anticMode = START_REGULAR_PLAYFIELD;
-                    HCOUNT = 48;
-                    usedCycles += 14;
+                    usedCycles += advanceTo(48);
                     break;
                 case 0x03:
                     //wide playfield
                     anticMode = START_WIDE_PLAYFIELD;
-                    HCOUNT = 44;    
-                    usedCycles += 10;
+                    usedCycles += advanceTo(44);
                     break;
             }
             break;
@@ -174,54 +450,47 @@ INT32 Antic::tick(INT32 minimum)
             //render the playfield area, 128 clocks
             renderLine();
             anticMode = END_NARROW_PLAYFIELD;
-            HCOUNT = 192;
-            usedCycles += 128;
+            usedCycles += advanceTo(192);
             break;
             
         case END_NARROW_PLAYFIELD:  //hclock == 192
             //render partial right border, 16 clocks
             anticMode = END_WSYNC;
-            HCOUNT = 208;
-            usedCycles += 16;
+            usedCycles += advanceTo(208);
             break;
             
         case START_REGULAR_PLAYFIELD:  //hclock == 48
             //render the playfield area, 160 clocks
             renderLine();
-            HCOUNT = 208;
             anticMode = END_REGULAR_PLAYFIELD;
-            usedCycles += 160;
+            usedCycles += advanceTo(208);
             break;
 
         case END_REGULAR_PLAYFIELD:  //hclock == 208
             //end WSYNC and render the right border, 14 clocks
             pinOut[ANTIC_PIN_OUT_READY]->isHigh = TRUE;
             anticMode = START_HBLANK;
-            HCOUNT = 222;
-            usedCycles += 14;
+            usedCycles += advanceTo(222);
             break;
             
         case START_WIDE_PLAYFIELD: //hclock == 44
             //render part of the playfield area, 164 clocks
             renderLine();
             anticMode = END_WSYNC_DURING_WIDE;
-            HCOUNT = 208;
-            usedCycles += 164;
+            usedCycles += advanceTo(208);
             break;
             
         case END_WSYNC_DURING_WIDE:  //hclock = 208
             //assert READY, in case someone did a WSYNC
             pinOut[ANTIC_PIN_OUT_READY]->isHigh = TRUE;
             anticMode = END_WIDE_PLAYFIELD;
-            HCOUNT = 220;
-            usedCycles += 12;
+            usedCycles += advanceTo(220);
             break;
             
         case END_WIDE_PLAYFIELD:  //hclock == 220
             //render the right border, 2 clocks
             anticMode = START_HBLANK;
-            HCOUNT = 222;
-            usedCycles += 2;
+            usedCycles += advanceTo(222);
             break;
             
         case END_WSYNC:  //hclock = 208
@@ -229,8 +498,7 @@ INT32 Antic::tick(INT32 minimum)
             pinOut[ANTIC_PIN_OUT_READY]->isHigh = TRUE;
             
             anticMode = START_HBLANK;
-            HCOUNT = 222;
-            usedCycles += 14;
+            usedCycles += advanceTo(222);
             break;
         
         case START_HBLANK: //hclock = 222
@@ -248,33 +516,22 @@ INT32 Antic::tick(INT32 minimum)
                 if ((DMACTL & 0x20) == 0) {
                     MODE = 0;
                     BLOCKLENGTH = 1;
-                    /*
-                    VCOUNT++;
-                    HCOUNT = 208;
-                    anticMode = END_WSYNC;
-                    usedCycles += 214;
-                    */
+                    cyclesToSteal = 0;
                 }
                 else {
-                    //fetch and decode the next instruction
-                    fetchAndDecode();
-                
-                    //load the SHIFT register; should steal cycles for this, but oh well
-                    for (UINT8 i = 0; i < BYTEWIDTH; i++) {
-                        SHIFT[i] = (UINT8)memoryBus->peek(MEMSCAN);
-                        MEMSCAN = (UINT16)((MEMSCAN & 0xF000) | ((MEMSCAN+1) & 0x0FFF));
-                    }
-
-                    /*
-                    VCOUNT++;
-                    HCOUNT = (UINT8)(HCOUNT+cyclesToSteal);
-                    pinOut[ANTIC_PIN_OUT_HALT].isHigh = true;
-                    anticMode = END_CYCLE_STEALING;
-                    afterCycleStealingMode = START_HSYNC;
-                    usedCycles += cyclesToSteal;
-                    */
+                    //fetch and decode the next instruction, and load the SHIFT
+                    //register
+                    fetchInstruction();
                 }
+                lineCyclesToSteal = cyclesToSteal;
             }
+            else
+                lineCyclesToSteal = 0;
+
+            //add the playfield, player-missile, and refresh dma for the next line
+            lineCyclesToSteal += DMA_CYCLES[LCOUNT == 0][MODE][DMACTL & 0x03];
+            lineCyclesToSteal += PM_DMA_CYCLES[(DMACTL & 0x0C) >> 2];
+            lineCyclesToSteal += REFRESH_DMA_CYCLES;
             
             //do player-missile DMA to the GTIA player-missile graphics registers
             if ((DMACTL & 0x08) && (gtia->GRACTL & 0x02)) {
@@ -291,16 +548,18 @@ INT32 Antic::tick(INT32 minimum)
             }
             
             //now move along to the next line
-            HCOUNT = 0;
             VCOUNT++;
             if (VCOUNT == 248)
                 anticMode = START_VBLANK;
             else
                 anticMode = START_HSYNC;
-            usedCycles += 6;
+            usedCycles += advanceTo(228);
+            HCOUNT = 0;
             break;
             
         case START_VBLANK:
+            present();
+            scheduleIndex = 0;
             processorBus->stop();
             //kick the nmi line
             if (NMIEN & 0x40) {
@@ -309,7 +568,9 @@ INT32 Antic::tick(INT32 minimum)
             }
             VCOUNT++;
             anticMode = VBLANK;
-            usedCycles += 228;
+            lineCyclesToSteal = REFRESH_DMA_CYCLES;
+            usedCycles += advanceTo(228);
+            HCOUNT = 0;
             break;
 
         case VBLANK:
@@ -318,18 +579,15 @@ INT32 Antic::tick(INT32 minimum)
                 VCOUNT = 0;
             else if (VCOUNT == 8)
                 anticMode = START_HSYNC;
-            usedCycles += 228;
+            lineCyclesToSteal = REFRESH_DMA_CYCLES;
+            usedCycles += advanceTo(228);
+            HCOUNT = 0;
             break;
 
         //this is a generic mode use to end a session of cycle stealing from the CPU
-        case END_CYCLE_STEALING:  //hclock == ???
-#if 0
+        case END_CYCLE_STEALING:  //hclock == lineCyclesToSteal
             pinOut[ANTIC_PIN_OUT_HALT]->isHigh = TRUE;
-            HCOUNT = (UINT8)(HCOUNT+cyclesToSteal);
-            cyclesToSteal = 0;
-            //anticMode = afterCycleStealingMode;
-            usedCycles += cyclesToSteal;
-#endif
+            anticMode = afterCycleStealingMode;
             break;
     }
     
@@ -383,75 +641,117 @@ void Antic::renderLine()
             render_F();
             break;
     }
-    
-    //render the four players
-    UINT32 lineStart = ((VCOUNT-8)*320);
-    for (INT32 i = 0; i < 4; i++) {
-        UINT8 nextPos = gtia->HPOSP[i];
-        if (nextPos < 0x30 || nextPos > 0xC8)
-            continue;
-
-        UINT32 byteStart = (lineStart + (2*(nextPos-0x30)));
-        renderPlayerGraphic(imageBank+byteStart, gtia->GRAFP[i], gtia->COLPM[i]);
-    }
+    borderColors[VCOUNT-8] = gtia->COLBK;
 
-    //render the four missiles or the fifth player
-    UINT8 nextPos = gtia->HPOSM[0];
-    if (nextPos >= 0x30 && nextPos <= 0xC8) {
-        UINT32 byteStart = (lineStart + (2*(nextPos-0x30)));
-        renderPlayerGraphic(imageBank+byteStart, gtia->GRAFM, gtia->COLPF[3]);
-    }
+    //let the gtia resolve the players, missiles, and priorities
+    gtia->compositeLine(imageBank + ((VCOUNT-8)*320), playfieldLine);
     
     LCOUNT++;
 }
 
-void Antic::renderPlayerGraphic(UINT8* ptr, UINT8 grafx, UINT8 color)
+void Antic::fetchInstruction()
 {
-    if (grafx & 0x80) {
-        *(ptr) = color;
-        *(ptr+1) = color;
-    }
-    ptr += 2;
-    if (grafx & 0x40) {
-        *(ptr) = color;
-        *(ptr+1) = color;
-    }
-    ptr += 2;
-    if (grafx & 0x20) {
-        *(ptr) = color;
-        *(ptr+1) = color;
-    }
-    ptr += 2;
-    if (grafx & 0x10) {
-        *(ptr) = color;
-        *(ptr+1) = color;
-    }
-    ptr += 2;
-    if (grafx & 0x08) {
-        *(ptr) = color;
-        *(ptr+1) = color;
+    //replay the compiled schedule for as long as it still matches
+    DisplayListEntry* entry = (scheduleIndex < DISPLAY_LIST_SCHEDULE_SIZE ? &schedule[scheduleIndex] : NULL);
+    scheduleIndex++;
+    if (entry && entry->valid && entry->dlistBefore == DLIST && entry->memscanBefore == MEMSCAN &&
+            entry->vcount == VCOUNT && entry->dmactl == DMACTL && isCurrent(&entry->dlistPages))
+    {
+        INST = entry->INST;
+        MODE = entry->MODE;
+        BYTEWIDTH = entry->BYTEWIDTH;
+        BLOCKLENGTH = entry->BLOCKLENGTH;
+        DLIST = entry->DLIST;
+        cyclesToSteal = entry->cyclesToSteal;
+
+        //the screen data is only refetched if its memory has been written
+        if (isCurrent(&entry->shiftPages)) {
+            memcpy(SHIFT, entry->SHIFT, BYTEWIDTH);
+            MEMSCAN = entry->MEMSCAN;
+            return;
+        }
+        MEMSCAN = entry->memscanStart;
+        recordingEntry = entry;
+        loadShiftRegister();
+        recordingEntry = NULL;
+        return;
     }
-    ptr += 2;
-    if (grafx & 0x04) {
-        *(ptr) = color;
-        *(ptr+1) = color;
+
+    //otherwise decode the instruction from memory and compile it into the
+    //schedule for the next frame
+    DisplayListEntry scratch;
+    recordingEntry = (entry ? entry : &scratch);
+    recordingEntry->valid = FALSE;
+    recordingEntry->dlistBefore = DLIST;
+    recordingEntry->memscanBefore = MEMSCAN;
+    recordingEntry->vcount = VCOUNT;
+    recordingEntry->dmactl = DMACTL;
+    recordingEntry->dlistPages.count = 0;
+    recordingEntry->dlistPages.cacheable = (watchedRAM != NULL);
+
+    fetchAndDecode();
+    recordingEntry->INST = INST;
+    recordingEntry->MODE = MODE;
+    recordingEntry->BYTEWIDTH = BYTEWIDTH;
+    recordingEntry->BLOCKLENGTH = BLOCKLENGTH;
+    recordingEntry->DLIST = DLIST;
+    recordingEntry->cyclesToSteal = cyclesToSteal;
+    recordingEntry->memscanStart = MEMSCAN;
+    loadShiftRegister();
+    recordingEntry->valid = recordingEntry->dlistPages.cacheable;
+    recordingEntry = NULL;
+}
+
+void Antic::loadShiftRegister()
+{
+    recordingEntry->shiftPages.count = 0;
+    recordingEntry->shiftPages.cacheable = (watchedRAM != NULL);
+    for (UINT8 i = 0; i < BYTEWIDTH; i++) {
+        SHIFT[i] = fetchByte(MEMSCAN, &recordingEntry->shiftPages);
+        MEMSCAN = (UINT16)((MEMSCAN & 0xF000) | ((MEMSCAN+1) & 0x0FFF));
     }
-    ptr += 2;
-    if (grafx & 0x02) {
-        *(ptr) = color;
-        *(ptr+1) = color;
+    memcpy(recordingEntry->SHIFT, SHIFT, BYTEWIDTH);
+    recordingEntry->MEMSCAN = MEMSCAN;
+}
+
+UINT8 Antic::fetchByte(UINT16 location, WatchedPages* pages)
+{
+    //note the page read and its generation, so the result can be reused
+    //for as long as nothing writes to it
+    if (pages->cacheable) {
+        if (!watchedRAM->contains(location))
+            pages->cacheable = FALSE;
+        else {
+            UINT16 page = (UINT16)(location & 0xFF00);
+            if (pages->count == 0 || pages->pages[pages->count-1] != page) {
+                if (pages->count == WATCHED_PAGES_SIZE)
+                    pages->cacheable = FALSE;
+                else {
+                    pages->pages[pages->count] = page;
+                    pages->generations[pages->count] = watchedRAM->getPageGeneration(location);
+                    pages->count++;
+                }
+            }
+        }
     }
-    ptr += 2;
-    if (grafx & 0x01) {
-        *(ptr) = color;
-        *(ptr+1) = color;
+    return (UINT8)memoryBus->peek(location);
+}
+
+BOOL Antic::isCurrent(const WatchedPages* pages)
+{
+    if (!pages->cacheable)
+        return FALSE;
+    for (UINT8 i = 0; i < pages->count; i++) {
+        if (watchedRAM->getPageGeneration(pages->pages[i]) != pages->generations[i])
+            return FALSE;
     }
+    return TRUE;
 }
 
 void Antic::fetchAndDecode()
 {
     //fetch the next instruction, and steal one cpu cycle to do it
-    INST = (UINT8)memoryBus->peek(DLIST);
+    INST = fetchByte(DLIST, &recordingEntry->dlistPages);
     DLIST = (UINT16)((DLIST & 0xFC00) | ((DLIST+1) & 0x03FF));
     cyclesToSteal = 2;
 
@@ -464,9 +764,9 @@ void Antic::fetchAndDecode()
     }
     else if (MODE == 0x01) {
         //execute a display list jump instruction, steal total of 3 cpu cycles
-        UINT8 lo = (UINT8)memoryBus->peek(DLIST);
+        UINT8 lo = fetchByte(DLIST, &recordingEntry->dlistPages);
         DLIST = (UINT16)((DLIST & 0xFC00) | ((DLIST+1) & 0x03FF));
-        UINT8 hi = (UINT8)memoryBus->peek(DLIST);
+        UINT8 hi = fetchByte(DLIST, &recordingEntry->dlistPages);
         DLIST = (UINT16)((hi << 8) | lo);
         
         //steal two more cpu cycles
@@ -483,9 +783,9 @@ void Antic::fetchAndDecode()
         //reload memscan if necessary
         if ((INST & 0x40) != 0) 
         {
-            UINT8 lo = (UINT8)memoryBus->peek(DLIST);
+            UINT8 lo = fetchByte(DLIST, &recordingEntry->dlistPages);
             DLIST = (UINT16)((DLIST & 0xFC00) | ((DLIST+1) & 0x03FF));
-            UINT8 hi = (UINT8)memoryBus->peek(DLIST);
+            UINT8 hi = fetchByte(DLIST, &recordingEntry->dlistPages);
             DLIST = (UINT16)((DLIST & 0xFC00) | ((DLIST+1) & 0x03FF));
             MEMSCAN = (UINT16)((hi << 8) | lo);
             //steal two cpu cycles
@@ -500,249 +800,251 @@ void Antic::fetchAndDecode()
 
 void Antic::render_blank()
 {
-    UINT32 lineStart = ((VCOUNT-8)*320);
-    for (INT32 i = 0; i < 20; i++) 
-    {
-        UINT32 byteStart = (lineStart + (i << 4));
-        memset(imageBank+byteStart, gtia->COLBK, 16);
+    memset(playfieldLine, ANBK, 320);
+}
+
+void Antic::initExpansionTables()
+{
+    static BOOL initialized = FALSE;
+    if (initialized)
+        return;
+
+    //the masks are built a byte at a time so that the first pixel of each
+    //data byte always lands at the lowest address, regardless of endianness
+    UINT8 pixels[16];
+    for (INT32 b = 0; b < 256; b++) {
+        //one bit per pixel
+        for (INT32 x = 0; x < 8; x++)
+            pixels[x] = (b & (0x80 >> x)) ? 0xFF : 0x00;
+        memcpy(&EXPAND_1BPP[b], pixels, 8);
+
+        //one bit per pixel, each pixel two wide
+        for (INT32 x = 0; x < 16; x++)
+            pixels[x] = (b & (0x80 >> (x >> 1))) ? 0xFF : 0x00;
+        memcpy(&EXPAND_1BPP_WIDE[b][0], pixels, 8);
+        memcpy(&EXPAND_1BPP_WIDE[b][1], pixels+8, 8);
+
+        //two bits per pixel, each pixel two wide, one mask per color code
+        for (INT32 c = 0; c < 4; c++) {
+            for (INT32 x = 0; x < 8; x++)
+                pixels[x] = (((b >> (6 - ((x >> 1) << 1))) & 0x03) == c) ? 0xFF : 0x00;
+            memcpy(&EXPAND_2BPP_WIDE[b][c], pixels, 8);
+        }
+
+        //four bits per pixel, each pixel four wide, for the gtia color modes
+        for (INT32 x = 0; x < 8; x++)
+            pixels[x] = (UINT8)(x < 4 ? b >> 4 : b & 0x0F);
+        memcpy(&EXPAND_NIBBLES[b], pixels, 8);
     }
+
+    //four bits of data stretched to a byte with every pixel doubled, so the
+    //wide masks above also serve the modes whose pixels are four wide
+    for (INT32 n = 0; n < 16; n++) {
+        WIDEN_1BPP[n] = (UINT8)(((n & 0x08) * 0x18) | ((n & 0x04) * 0x0C) |
+                ((n & 0x02) * 0x06) | ((n & 0x01) * 0x03));
+        WIDEN_2BPP[n] = (UINT8)(((n >> 2) * 0x50) | ((n & 0x03) * 0x05));
+    }
+
+    initialized = TRUE;
+}
+
+UINT8 Antic::fetchGlyphRow(UINT16 charBase, UINT8 index)
+{
+    //each distinct character is fetched from the bus only once per line
+    UINT64 bit = (UINT64)1 << (index & 0x3F);
+    if (glyphCached[index >> 6] & bit)
+        return glyphRows[index];
+
+    glyphRows[index] = (UINT8)memoryBus->peek((UINT16)(charBase | (index << 3)));
+    glyphCached[index >> 6] |= bit;
+    return glyphRows[index];
 }
 
 void Antic::render_2()
 {
-    UINT8 mixedColor = (gtia->COLPF[2] & 0xF0) | (gtia->COLPF[1] & 0x0F);
-    UINT32 lineStart = ((VCOUNT-8)*320);
+    UINT64 background = SPLAT(ANPF2);
+    UINT64 difference = background ^ SPLAT(AN_SPECIAL);
+    UINT16 charBase = (UINT16)(((CHBASE & 0xFC) << 8) | (LCOUNT & 0x07));
+    UINT8* nextByte = playfieldLine;
+    glyphCached[0] = glyphCached[1] = 0;
+    if (gtia->PRIOR & 0xC0) {
+        //the gtia color modes take the raw data four bits at a time
+        for (INT32 i = 0; i < 40; i++) {
+            STORE64(nextByte, EXPAND_NIBBLES[fetchGlyphRow(charBase, SHIFT[i] & 0x7F)]);
+            nextByte += 8;
+        }
+        return;
+    }
     for (INT32 i = 0; i < 40; i++) {
-        UINT32 byteStart = (lineStart + (i << 3));
-        UINT16 charAddr = (UINT16)(((CHBASE & 0xFC) << 8) |
-                ((SHIFT[i] & 0x7F) << 3) | (LCOUNT & 0x07));
-        UINT8 dataByte = (UINT8)memoryBus->peek(charAddr);
-        imageBank[byteStart++] = dataByte & 0x80 ? mixedColor : gtia->COLPF[2];
-        imageBank[byteStart++] = dataByte & 0x40 ? mixedColor : gtia->COLPF[2];
-        imageBank[byteStart++] = dataByte & 0x20 ? mixedColor : gtia->COLPF[2];
-        imageBank[byteStart++] = dataByte & 0x10 ? mixedColor : gtia->COLPF[2];
-        imageBank[byteStart++] = dataByte & 0x08 ? mixedColor : gtia->COLPF[2];
-        imageBank[byteStart++] = dataByte & 0x04 ? mixedColor : gtia->COLPF[2];
-        imageBank[byteStart++] = dataByte & 0x02 ? mixedColor : gtia->COLPF[2];
-        imageBank[byteStart++] = dataByte & 0x01 ? mixedColor : gtia->COLPF[2];
+        UINT8 dataByte = fetchGlyphRow(charBase, SHIFT[i] & 0x7F);
+        STORE64(nextByte, background ^ (difference & EXPAND_1BPP[dataByte]));
+        nextByte += 8;
     }
 }
 
 void Antic::render_3()
 {
-    UINT32 lineStart = ((VCOUNT-8)*320);
-    for (INT32 i = 0; i < 320; i++)
-        imageBank[lineStart+i] = (UINT8)(rand() % 256);
+    UINT64 background = SPLAT(ANPF2);
+    UINT64 difference = background ^ SPLAT(AN_SPECIAL);
+    UINT16 charBase = (UINT16)(((CHBASE & 0xFC) << 8) | (LCOUNT & 0x07));
+    //the last quarter of the set is drawn two lines lower, its first two
+    //rows showing as descenders on lines eight and nine of the block
+    BOOL showUpper = (LCOUNT < 8);
+    BOOL showLower = (LCOUNT >= 2);
+    UINT8* nextByte = playfieldLine;
+    glyphCached[0] = glyphCached[1] = 0;
+    BOOL gtiaColors = ((gtia->PRIOR & 0xC0) != 0);
+    for (INT32 i = 0; i < 40; i++) {
+        UINT8 index = (UINT8)(SHIFT[i] & 0x7F);
+        UINT8 dataByte = 0;
+        if (index < 0x60 ? showUpper : showLower)
+            dataByte = fetchGlyphRow(charBase, index);
+        STORE64(nextByte, gtiaColors ? EXPAND_NIBBLES[dataByte] :
+                background ^ (difference & EXPAND_1BPP[dataByte]));
+        nextByte += 8;
+    }
 }
 
 void Antic::render_4_5()
 {
-    UINT8 anPalette[4] = { ANBK, ANPF0, ANPF2, ANPF3 };
-    UINT8 colorPalette[4] = { gtia->COLBK, gtia->COLPF[0], gtia->COLPF[2], gtia->COLPF[3] };
-    UINT32 lineStart = ((VCOUNT-8)*320);
+    UINT64 colorPalette[4] = { SPLAT(ANBK), SPLAT(ANPF0), 0, SPLAT(ANPF3) };
+    UINT64 normalColor = SPLAT(ANPF1);
+    UINT64 inverseColor = SPLAT(ANPF2);
+    UINT16 charBase = (UINT16)(((CHBASE & 0xFC) << 8) |
+            (MODE == 4 ? LCOUNT & 0x07 : (LCOUNT & 0x0E) >> 1));
+    UINT8* nextByte = playfieldLine;
+    glyphCached[0] = glyphCached[1] = 0;
     for (INT32 i = 0; i < 40; i++) {
-        UINT32 byteStart = (lineStart + (i << 3));
-        anPalette[2] = (UINT8)((SHIFT[i] & 0x80) == 0 ? ANPF1 : ANPF2);
-        colorPalette[2] = (UINT8)((SHIFT[i] & 0x80) == 0 ? gtia->COLPF[1] : gtia->COLPF[2]);
-        UINT16 charAddr = (UINT16)(((CHBASE & 0xFC) << 8) | ((SHIFT[i] & 0x7F) << 3));
-        charAddr |= (MODE == 4 ? LCOUNT & 0x07 : (LCOUNT & 0x0E) >> 1);
-        UINT8 dataByte = (UINT8)memoryBus->peek(charAddr);
-        UINT8 color = colorPalette[(dataByte & 0xC0) >> 6];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = colorPalette[(dataByte & 0x30) >> 4];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = colorPalette[(dataByte & 0x0C) >> 2];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = colorPalette[dataByte & 0x03];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
+        colorPalette[2] = ((SHIFT[i] & 0x80) == 0 ? normalColor : inverseColor);
+        const UINT64* masks = EXPAND_2BPP_WIDE[fetchGlyphRow(charBase, SHIFT[i] & 0x7F)];
+        STORE64(nextByte, (colorPalette[0] & masks[0]) | (colorPalette[1] & masks[1]) |
+                (colorPalette[2] & masks[2]) | (colorPalette[3] & masks[3]));
+        nextByte += 8;
     }
 }
 
 void Antic::render_6_7()
 {
-    UINT32 lineStart = ((VCOUNT-8)*320);
-    for (INT32 i = 0; i < 20; i++) 
-    {
-        UINT32 byteStart = (lineStart + (i << 4));
-        UINT16 charAddr = (UINT16)(((CHBASE & 0xFE) << 8) |
-            ((SHIFT[i] & 0x3F) << 3));
-        charAddr |= (MODE == 6 ? LCOUNT & 0x07 : (LCOUNT & 0x0E) >> 1);
-        UINT8 dataByte = (UINT8)memoryBus->peek(charAddr);
-        UINT8 fgcolor = gtia->COLPF[(SHIFT[i] & 0xC0) >> 6];
-        UINT8 color = (dataByte & 0x80 ? fgcolor : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = (dataByte & 0x40 ? fgcolor : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = (dataByte & 0x20 ? fgcolor : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = (dataByte & 0x10 ? fgcolor : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = (dataByte & 0x08 ? fgcolor : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = (dataByte & 0x04 ? fgcolor : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = (dataByte & 0x02 ? fgcolor : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = (dataByte & 0x01 ? fgcolor : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
+    UINT64 background = SPLAT(ANBK);
+    UINT64 differences[4] = {
+        background ^ SPLAT(ANPF0), background ^ SPLAT(ANPF1),
+        background ^ SPLAT(ANPF2), background ^ SPLAT(ANPF3) };
+    UINT16 charBase = (UINT16)(((CHBASE & 0xFE) << 8) |
+            (MODE == 6 ? LCOUNT & 0x07 : (LCOUNT & 0x0E) >> 1));
+    UINT8* nextByte = playfieldLine;
+    glyphCached[0] = glyphCached[1] = 0;
+    for (INT32 i = 0; i < 20; i++) {
+        const UINT64* masks = EXPAND_1BPP_WIDE[fetchGlyphRow(charBase, SHIFT[i] & 0x3F)];
+        UINT64 difference = differences[(SHIFT[i] & 0xC0) >> 6];
+        STORE64(nextByte, background ^ (difference & masks[0]));
+        STORE64(nextByte+8, background ^ (difference & masks[1]));
+        nextByte += 16;
     }
 }
 
 void Antic::render_8()
 {
-    UINT8 colorPalette[4] = { gtia->COLBK, gtia->COLPF[0], gtia->COLPF[1], gtia->COLPF[2] };
-    UINT32 lineStart = ((VCOUNT-8)*320);
-    for (INT32 i = 0; i < BYTEWIDTH; i++) 
-    {
-        UINT32 byteStart = (lineStart + (i << 3));
+    UINT64 colorPalette[4] = { SPLAT(ANBK), SPLAT(ANPF0), SPLAT(ANPF1), SPLAT(ANPF2) };
+    UINT8* nextByte = playfieldLine;
+    for (INT32 i = 0; i < BYTEWIDTH; i++) {
         UINT8 dataByte = SHIFT[i];
-        memset(imageBank+byteStart, colorPalette[(dataByte & 0xC0) >> 6], 8);
-        memset(imageBank+byteStart+8, colorPalette[(dataByte & 0x30) >> 4], 8);
-        memset(imageBank+byteStart+16, colorPalette[(dataByte & 0x0C) >> 2], 8);
-        memset(imageBank+byteStart+24, colorPalette[dataByte & 0x03], 8);
+        STORE64(nextByte, colorPalette[(dataByte & 0xC0) >> 6]);
+        STORE64(nextByte+8, colorPalette[(dataByte & 0x30) >> 4]);
+        STORE64(nextByte+16, colorPalette[(dataByte & 0x0C) >> 2]);
+        STORE64(nextByte+24, colorPalette[dataByte & 0x03]);
+        nextByte += 32;
     }
 }
 
 void Antic::render_9()
 {
-    UINT32 lineStart = ((VCOUNT-8)*320);
-    for (INT32 i = 0; i < 320; i++)
-        imageBank[lineStart+i] = (UINT8)(rand() % 256);
+    UINT64 background = SPLAT(ANBK);
+    UINT64 difference = background ^ SPLAT(ANPF0);
+    UINT8* nextByte = playfieldLine;
+    for (INT32 i = 0; i < BYTEWIDTH; i++) {
+        const UINT64* masks = EXPAND_1BPP_WIDE[WIDEN_1BPP[SHIFT[i] >> 4]];
+        STORE64(nextByte, background ^ (difference & masks[0]));
+        STORE64(nextByte+8, background ^ (difference & masks[1]));
+        masks = EXPAND_1BPP_WIDE[WIDEN_1BPP[SHIFT[i] & 0x0F]];
+        STORE64(nextByte+16, background ^ (difference & masks[0]));
+        STORE64(nextByte+24, background ^ (difference & masks[1]));
+        nextByte += 32;
+    }
 }
 
 void Antic::render_A()
 {
-    UINT8 colorPalette[4] = { gtia->COLBK, gtia->COLPF[0], gtia->COLPF[1], gtia->COLPF[2] };
-    UINT32 lineStart = ((VCOUNT-8)*320);
-    for (INT32 i = 0; i < BYTEWIDTH; i++) 
-    {
-        UINT32 byteStart = (lineStart + (i << 4));
-        UINT8 dataByte = SHIFT[i];
-        UINT8 color = colorPalette[(dataByte & 0xC0)>>6];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = colorPalette[(dataByte & 0x30)>>4];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = colorPalette[(dataByte & 0x0C)>>2];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = colorPalette[dataByte & 0x03];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
+    UINT64 colorPalette[4] = { SPLAT(ANBK), SPLAT(ANPF0), SPLAT(ANPF1), SPLAT(ANPF2) };
+    UINT8* nextByte = playfieldLine;
+    for (INT32 i = 0; i < BYTEWIDTH; i++) {
+        const UINT64* masks = EXPAND_2BPP_WIDE[WIDEN_2BPP[SHIFT[i] >> 4]];
+        STORE64(nextByte, (colorPalette[0] & masks[0]) | (colorPalette[1] & masks[1]) |
+                (colorPalette[2] & masks[2]) | (colorPalette[3] & masks[3]));
+        masks = EXPAND_2BPP_WIDE[WIDEN_2BPP[SHIFT[i] & 0x0F]];
+        STORE64(nextByte+8, (colorPalette[0] & masks[0]) | (colorPalette[1] & masks[1]) |
+                (colorPalette[2] & masks[2]) | (colorPalette[3] & masks[3]));
+        nextByte += 16;
     }
 }
 
 void Antic::render_B()
 {
-    UINT32 lineStart = ((VCOUNT-8)*320);
+    UINT64 background = SPLAT(ANBK);
+    UINT64 difference = background ^ SPLAT(ANPF0);
+    UINT8* nextByte = playfieldLine;
     for (INT32 i = 0; i < BYTEWIDTH; i++) {
-        UINT32 byteStart = (lineStart + (i << 4));
-        UINT8 color = (SHIFT[i] & 0x80 ? gtia->COLPF[0] : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = (SHIFT[i] & 0x40 ? gtia->COLPF[0] : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = (SHIFT[i] & 0x20 ? gtia->COLPF[0] : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = (SHIFT[i] & 0x10 ? gtia->COLPF[0] : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = (SHIFT[i] & 0x08 ? gtia->COLPF[0] : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = (SHIFT[i] & 0x04 ? gtia->COLPF[0] : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = (SHIFT[i] & 0x02 ? gtia->COLPF[0] : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = (SHIFT[i] & 0x01 ? gtia->COLPF[0] : gtia->COLBK);
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
+        const UINT64* masks = EXPAND_1BPP_WIDE[SHIFT[i]];
+        STORE64(nextByte, background ^ (difference & masks[0]));
+        STORE64(nextByte+8, background ^ (difference & masks[1]));
+        nextByte += 16;
     }
 }
 
 void Antic::render_C()
 {
-    UINT32 lineStart = ((VCOUNT-8)*320);
-    for (INT32 i = 0; i < 320; i++)
-        imageBank[lineStart+i] = (UINT8)(rand() % 256);
+    //the same two-color bitmap as mode B, one line high
+    render_B();
 }
 
 void Antic::render_D()
 {
-    //UINT8 anPalette[4] = { ANBK, ANPF0, ANPF1, ANPF2 };
-    UINT8 colorPalette[4] = { gtia->COLBK, gtia->COLPF[0], gtia->COLPF[1], gtia->COLPF[2] };
-    UINT32 lineStart = ((VCOUNT-8)*320);
+    UINT64 colorPalette[4] = { SPLAT(ANBK), SPLAT(ANPF0), SPLAT(ANPF1), SPLAT(ANPF2) };
+    UINT8* nextByte = playfieldLine;
     for (INT32 i = 0; i < BYTEWIDTH; i++) {
-        UINT32 byteStart = (lineStart + (i << 3));
-        UINT8 color = colorPalette[(SHIFT[i] & 0xC0) >> 6];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = colorPalette[(SHIFT[i] & 0x30) >> 4];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = colorPalette[(SHIFT[i] & 0x0C) >> 2];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = colorPalette[SHIFT[i] & 0x03];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
+        const UINT64* masks = EXPAND_2BPP_WIDE[SHIFT[i]];
+        STORE64(nextByte, (colorPalette[0] & masks[0]) | (colorPalette[1] & masks[1]) |
+                (colorPalette[2] & masks[2]) | (colorPalette[3] & masks[3]));
+        nextByte += 8;
     }
 }
 
 void Antic::render_E()
 {
-    UINT8 colorPalette[4] = { gtia->COLBK, gtia->COLPF[0], gtia->COLPF[1], gtia->COLPF[2] };
-    UINT32 lineStart = ((VCOUNT-8)*320);
-    for (INT32 i = 0; i < BYTEWIDTH; i++) 
-    {
-        UINT32 byteStart = (lineStart + (i << 3));
-        UINT8 color = colorPalette[(SHIFT[i] & 0xC0) >> 6];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = colorPalette[(SHIFT[i] & 0x30) >> 4];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = colorPalette[(SHIFT[i] & 0x0C) >> 2];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
-        color = colorPalette[SHIFT[i] & 0x03];
-        imageBank[byteStart++] = color;
-        imageBank[byteStart++] = color;
+    UINT64 colorPalette[4] = { SPLAT(ANBK), SPLAT(ANPF0), SPLAT(ANPF1), SPLAT(ANPF2) };
+    UINT8* nextByte = playfieldLine;
+    for (INT32 i = 0; i < BYTEWIDTH; i++) {
+        const UINT64* masks = EXPAND_2BPP_WIDE[SHIFT[i]];
+        STORE64(nextByte, (colorPalette[0] & masks[0]) | (colorPalette[1] & masks[1]) |
+                (colorPalette[2] & masks[2]) | (colorPalette[3] & masks[3]));
+        nextByte += 8;
     }
 }
 
 void Antic::render_F()
 {
-    UINT32 lineStart = ((VCOUNT-8)*320);
-    UINT8 mixedColor = (gtia->COLPF[2] & 0xF0) | (gtia->COLPF[1] & 0x0F);
-    for (INT32 i = 0; i < BYTEWIDTH; i++) 
-    {
-        UINT32 byteStart = (lineStart + (i << 3));
-        UINT8 dataByte = SHIFT[i];
-        imageBank[byteStart++] = (dataByte & 0x80 ? mixedColor : gtia->COLPF[2]);
-        imageBank[byteStart++] = (dataByte & 0x40 ? mixedColor : gtia->COLPF[2]);
-        imageBank[byteStart++] = (dataByte & 0x20 ? mixedColor : gtia->COLPF[2]);
-        imageBank[byteStart++] = (dataByte & 0x10 ? mixedColor : gtia->COLPF[2]);
-        imageBank[byteStart++] = (dataByte & 0x08 ? mixedColor : gtia->COLPF[2]);
-        imageBank[byteStart++] = (dataByte & 0x04 ? mixedColor : gtia->COLPF[2]);
-        imageBank[byteStart++] = (dataByte & 0x02 ? mixedColor : gtia->COLPF[2]);
-        imageBank[byteStart++] = (dataByte & 0x01 ? mixedColor : gtia->COLPF[2]);
+    UINT64 background = SPLAT(ANPF2);
+    UINT64 difference = background ^ SPLAT(AN_SPECIAL);
+    UINT8* nextByte = playfieldLine;
+    if (gtia->PRIOR & 0xC0) {
+        //the gtia color modes take the raw data four bits at a time
+        for (INT32 i = 0; i < BYTEWIDTH; i++) {
+            STORE64(nextByte, EXPAND_NIBBLES[SHIFT[i]]);
+            nextByte += 8;
+        }
+        return;
+    }
+    for (INT32 i = 0; i < BYTEWIDTH; i++) {
+        STORE64(nextByte, background ^ (difference & EXPAND_1BPP[SHIFT[i]]));
+        nextByte += 8;
     }
 }
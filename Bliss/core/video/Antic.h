@@ -8,11 +8,53 @@
 #include "core/cpu/Processor.h"
 #include "core/cpu/SignalLine.h"
 #include "core/memory/MemoryBus.h"
+#include "core/memory/WatchedRAM.h"
 
 #define ANTIC_PIN_OUT_NMI   0
 #define ANTIC_PIN_OUT_HALT  1
 #define ANTIC_PIN_OUT_READY 2
 
+#define DISPLAY_LIST_SCHEDULE_SIZE  240
+#define WATCHED_PAGES_SIZE          2
+
+/**
+ * The RAM pages (and their write generations) that a cached result was
+ * read from; the result is current until any of those pages is written.
+ */
+typedef struct _WatchedPages
+{
+    BOOL   cacheable;
+    UINT8  count;
+    UINT16 pages[WATCHED_PAGES_SIZE];
+    UINT32 generations[WATCHED_PAGES_SIZE];
+} WatchedPages;
+
+/**
+ * One display list instruction as fetched during a frame: the state it was
+ * fetched in, the decoded result, and the screen data loaded for it.
+ */
+typedef struct _DisplayListEntry
+{
+    BOOL   valid;
+    UINT16 dlistBefore;
+    UINT16 memscanBefore;
+    UINT16 vcount;
+    UINT8  dmactl;
+
+    UINT8  INST;
+    UINT8  MODE;
+    UINT8  BYTEWIDTH;
+    UINT8  BLOCKLENGTH;
+    UINT16 DLIST;
+    UINT16 memscanStart;
+    UINT16 MEMSCAN;
+    UINT16 cyclesToSteal;
+    UINT8  SHIFT[48];
+
+    WatchedPages dlistPages;
+    WatchedPages shiftPages;
+} DisplayListEntry;
+
 typedef enum _AnticMode
 {
     START_HSYNC,
@@ -32,6 +74,33 @@ typedef enum _AnticMode
     END_CYCLE_STEALING,
 } AnticMode;
 
+TYPEDEF_STRUCT_PACK( _AnticState
+{
+    UINT8  SHIFT[48];
+    UINT16 MEMSCAN;
+    UINT16 DLIST;
+    UINT16 VCOUNT;
+    UINT16 cyclesToSteal;
+    INT32  anticMode;
+    INT32  afterCycleStealingMode;
+    UINT8  INST;
+    UINT8  LCOUNT;
+    UINT8  HCOUNT;
+    UINT8  MODE;
+    UINT8  BYTEWIDTH;
+    UINT8  BLOCKLENGTH;
+    UINT8  DMACTL;
+    UINT8  CHACTL;
+    UINT8  HSCROL;
+    UINT8  VSCROL;
+    UINT8  PMBASE;
+    UINT8  CHBASE;
+    UINT8  NMIEN;
+    UINT8  NMIST;
+    UINT8  lineCyclesToSteal;
+    UINT8  _pad[1];
+} AnticState; )
+
 class Antic : public Processor, public VideoProducer
 {
     friend class Antic_Registers;
@@ -44,6 +113,16 @@ public:
     void resetProcessor();
 	void setPixelBuffer(UINT32* pixelBuffer, UINT32 rowSize);
 
+    /**
+     * Sets the RAM whose page writes are watched to decide when the compiled
+     * display list schedule must be refetched. Display lists and screen data
+     * outside of this RAM are always fetched from the bus.
+     */
+    void setWatchedRAM(WatchedRAM* ram);
+
+    AnticState getState();
+    void setState(AnticState state);
+
     void render();
 
     INT32 getClockSpeed() { return 3584160; }
@@ -53,7 +132,7 @@ public:
 
 private:
 
-    void renderPlayerGraphic(UINT8* ptr, UINT8 grafx, UINT8 color);
+    void present();
     
     const static UINT8 ANBK;
     const static UINT8 ANPF0;
@@ -62,11 +141,34 @@ private:
     const static UINT8 ANPF3;
     const static UINT8 AN_SPECIAL;
 
+    /**
+     * The color clocks of cpu time stolen by dma on a line: playfield dma
+     * indexed by [first line of block][mode][DMACTL playfield width], and
+     * player-missile dma indexed by DMACTL bits 2-3.
+     */
+    static UINT8 DMA_CYCLES[2][16][4];
+    const static UINT8 PM_DMA_CYCLES[4];
+    const static UINT8 REFRESH_DMA_CYCLES;
+    static void initDMATables();
+
     const static UINT8 BLOCK_HEIGHTS[14];
     const static UINT8 BYTE_WIDTHS[14][4];
             
     const static UINT32 palette[256];
 
+    /**
+     * Per data byte, a mask with 0xFF in each output pixel that selects the
+     * foreground (1BPP) or a given color code (2BPP), so a whole row of
+     * pixels can be composed with a few word operations and one store.
+     */
+    static UINT64 EXPAND_1BPP[256];
+    static UINT64 EXPAND_1BPP_WIDE[256][2];
+    static UINT64 EXPAND_2BPP_WIDE[256][4];
+    static UINT64 EXPAND_NIBBLES[256];
+    static UINT8 WIDEN_1BPP[16];
+    static UINT8 WIDEN_2BPP[16];
+    static void initExpansionTables();
+
     MemoryBus* memoryBus;
     GTIA* gtia;
 
@@ -95,15 +197,42 @@ private:
     AnticMode anticMode;
     
     UINT16 cyclesToSteal;
-    //private AnticMode afterCycleStealingMode;
+    UINT8  lineCyclesToSteal;
+    AnticMode afterCycleStealingMode;
 
 	UINT32*					pixelBuffer;
 	UINT32					pixelBufferRowSize;
 
+    //the background color latched as each line was rendered, used to fill
+    //the left and right borders when the frame is presented
+    UINT8  borderColors[240];
+
+    //the playfield codes (ANBK, ANPFn, AN_SPECIAL) for the current line,
+    //wide enough for a full wide playfield; the gtia turns them into colors
+    UINT8  playfieldLine[384];
+
+    //the display list as compiled during previous frames, one entry per
+    //instruction fetched, replayed while its inputs are unchanged
+    WatchedRAM*      watchedRAM;
+    DisplayListEntry schedule[DISPLAY_LIST_SCHEDULE_SIZE];
+    UINT32           scheduleIndex;
+    DisplayListEntry* recordingEntry;
+
+    //the character rows already fetched while rendering the current line
+    UINT8  glyphRows[128];
+    UINT64 glyphCached[2];
+
 private:
     void renderLine();
+    UINT8 advanceTo(UINT8 hclock);
     
+    void fetchInstruction();
     void fetchAndDecode();
+    void loadShiftRegister();
+    UINT8 fetchByte(UINT16 location, WatchedPages* pages);
+    BOOL isCurrent(const WatchedPages* pages);
+    void invalidateSchedule();
+    UINT8 fetchGlyphRow(UINT16 charBase, UINT8 index);
     
     void render_blank();
     void render_2();
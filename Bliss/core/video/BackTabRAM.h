@@ -15,6 +15,7 @@ TYPEDEF_STRUCT_PACK( _BackTabRAMState
 
 class BackTabRAM : public RAM
 {
+    friend class AY38900;
 
     public:
         BackTabRAM();
@@ -3,11 +3,89 @@
 
 #include <stdio.h>
 
+//the playfield codes produced by the Antic
+#define AN_BK               0x0
+#define AN_HIRES            0x1
+#define AN_PF0              0x4
+#define AN_PF1              0x5
+#define AN_PF2              0x6
+#define AN_PF3              0x7
+
+//the color registers a pixel can resolve to
+#define COLOR_BK            0
+#define COLOR_PF0           1
+#define COLOR_PF1           2
+#define COLOR_PF2           3
+#define COLOR_PF3           4
+#define COLOR_PM0           5
+#define COLOR_PM1           6
+#define COLOR_PM2           7
+#define COLOR_PM3           8
+#define COLOR_PM01          9
+#define COLOR_PM23          10
+#define COLOR_HIRES         11
+#define COLOR_COUNT         12
+
+//the priority classes ordered by the low bits of PRIOR
+#define CLASS_P01           0
+#define CLASS_P23           1
+#define CLASS_PF01          2
+#define CLASS_PF23          3
+
+//pixels per bit of player/missile graphics for each SIZEP/SIZEM setting
+const UINT8 GTIA::PLAYER_WIDTHS[4] = { 2, 4, 2, 8 };
+
+UINT64 GTIA::EXPAND_GRAFX[4][256];
+
+//returns one bit for each of eight playfield codes (first pixel in the
+//lowest byte) that equals the given code
+static inline UINT64 matchingPixels(UINT64 codes, UINT8 code)
+{
+    UINT64 t = codes ^ (0x0101010101010101ULL * code);
+    UINT64 zero = ~(((t & 0x7F7F7F7F7F7F7F7FULL) + 0x7F7F7F7F7F7F7F7FULL) | t | 0x7F7F7F7F7F7F7F7FULL);
+    return ((zero >> 7) * 0x0102040810204080ULL) >> 56;
+}
+
+//highest to lowest priority for PRIOR bits 0-3; the last entry is used
+//when no priority bit is set
+const UINT8 GTIA::PRIORITY_ORDERS[5][4] = {
+    { CLASS_P01,  CLASS_P23,  CLASS_PF01, CLASS_PF23 },
+    { CLASS_P01,  CLASS_PF01, CLASS_PF23, CLASS_P23  },
+    { CLASS_PF01, CLASS_PF23, CLASS_P01,  CLASS_P23  },
+    { CLASS_PF01, CLASS_P01,  CLASS_P23,  CLASS_PF23 },
+    { CLASS_P01,  CLASS_P23,  CLASS_PF01, CLASS_PF23 } };
+
 
 GTIA::GTIA()
-    : Processor("GTIA")
+    : Processor("GTIA"),
+      objectLineDirty(TRUE),
+      objectsPresent(0),
+      priorityTablePrior(0xFF)
 {
     registers.init(this);
+    memset(imageBank, 0, sizeof(imageBank));
+    initExpansionTables();
+}
+
+void GTIA::initExpansionTables()
+{
+    static BOOL initialized = FALSE;
+    if (initialized)
+        return;
+
+    for (INT32 size = 0; size < 4; size++) {
+        UINT8 pixelWidth = PLAYER_WIDTHS[size];
+        for (INT32 grafx = 0; grafx < 256; grafx++) {
+            UINT64 pattern = 0;
+            for (INT32 x = 0; x < 8*pixelWidth; x++) {
+                if (grafx & (0x80 >> (x / pixelWidth)))
+                    pattern |= (UINT64)1 << x;
+            }
+            EXPAND_GRAFX[size][grafx] = pattern;
+        }
+    }
+
+    initialized = TRUE;
 }
 
 void GTIA::resetProcessor()
@@ -25,62 +103,308 @@ void GTIA::resetProcessor()
     VDELAY = 0;
     GRACTL = 0;
     memset(MPF, 0, sizeof(MPF));
-    memset(PPL, 0, sizeof(PPF));
-    memset(MPF, 0, sizeof(MPL));
+    memset(PPF, 0, sizeof(PPF));
+    memset(MPL, 0, sizeof(MPL));
     memset(PPL, 0, sizeof(PPL));
     memset(TRIG, 0, sizeof(TRIG));
     CONSOL = 0;
+
+    objectLineDirty = TRUE;
+    priorityTablePrior = 0xFF;
 }
 
-/* GTIA modes are not yet supported for performanc reasons
-void GTIA::process(UINT16 location, UINT8 an0, UINT8 color0, UINT8 an1, UINT8 color1)
+GTIAState GTIA::getState()
 {
-    switch (PRIOR & 0xC0) {
-        case 0x00:
-        {
-            imageBank[location] = color0;
-            imageBank[location+1] = color1;
+    GTIAState state = {0};
+
+    memcpy(state.HPOSP, this->HPOSP, sizeof(this->HPOSP));
+    memcpy(state.HPOSM, this->HPOSM, sizeof(this->HPOSM));
+    memcpy(state.SIZEP, this->SIZEP, sizeof(this->SIZEP));
+    memcpy(state.GRAFP, this->GRAFP, sizeof(this->GRAFP));
+    memcpy(state.COLPM, this->COLPM, sizeof(this->COLPM));
+    memcpy(state.COLPF, this->COLPF, sizeof(this->COLPF));
+    memcpy(state.MPF, this->MPF, sizeof(this->MPF));
+    memcpy(state.PPF, this->PPF, sizeof(this->PPF));
+    memcpy(state.MPL, this->MPL, sizeof(this->MPL));
+    memcpy(state.PPL, this->PPL, sizeof(this->PPL));
+    memcpy(state.TRIG, this->TRIG, sizeof(this->TRIG));
+    state.SIZEM = this->SIZEM;
+    state.GRAFM = this->GRAFM;
+    state.COLBK = this->COLBK;
+    state.PRIOR = this->PRIOR;
+    state.VDELAY = this->VDELAY;
+    state.GRACTL = this->GRACTL;
+    state.CONSOL = this->CONSOL;
+
+    return state;
+}
+
+void GTIA::setState(GTIAState state)
+{
+    memcpy(this->HPOSP, state.HPOSP, sizeof(this->HPOSP));
+    memcpy(this->HPOSM, state.HPOSM, sizeof(this->HPOSM));
+    memcpy(this->SIZEP, state.SIZEP, sizeof(this->SIZEP));
+    memcpy(this->GRAFP, state.GRAFP, sizeof(this->GRAFP));
+    memcpy(this->COLPM, state.COLPM, sizeof(this->COLPM));
+    memcpy(this->COLPF, state.COLPF, sizeof(this->COLPF));
+    memcpy(this->MPF, state.MPF, sizeof(this->MPF));
+    memcpy(this->PPF, state.PPF, sizeof(this->PPF));
+    memcpy(this->MPL, state.MPL, sizeof(this->MPL));
+    memcpy(this->PPL, state.PPL, sizeof(this->PPL));
+    memcpy(this->TRIG, state.TRIG, sizeof(this->TRIG));
+    this->SIZEM = state.SIZEM;
+    this->GRAFM = state.GRAFM;
+    this->COLBK = state.COLBK;
+    this->PRIOR = state.PRIOR;
+    this->VDELAY = state.VDELAY;
+    this->GRACTL = state.GRACTL;
+    this->CONSOL = state.CONSOL;
+
+    //the cached object line and priority table follow the new registers
+    objectLineDirty = TRUE;
+    priorityTablePrior = 0xFF;
+}
+
+void GTIA::buildPriorityTable()
+{
+    UINT8 order = 4;
+    for (UINT8 i = 0; i < 4; i++) {
+        if (PRIOR & (1 << i)) {
+            order = i;
             break;
         }
-        case 0x40:
-        {
-            UINT8 color = COLBK;
-            if ((an0 & 0x04) == 0)
-                color |=  (an0 & 0x03) << 2;
-            if ((an1 & 0x04) == 0)
-                color |= (an1 & 0x03);
-            imageBank[location] = color;
-            imageBank[location+1] = color;
-            break;
+    }
+    BOOL fifthPlayer = (PRIOR & 0x10) != 0;
+    BOOL multiColor = (PRIOR & 0x20) != 0;
+
+    for (INT32 an = 0; an < 8; an++) {
+        for (INT32 objects = 0; objects < 256; objects++) {
+            UINT8 players = (UINT8)(objects & 0x0F);
+            UINT8 missiles = (UINT8)(objects >> 4);
+            if (!fifthPlayer)
+                players |= missiles;
+
+            //the playfield color, which the fifth player overrides
+            UINT8 playfield = COLOR_BK;
+            if (fifthPlayer && missiles)
+                playfield = COLOR_PF3;
+            else if (an >= AN_PF0)
+                playfield = (UINT8)(COLOR_PF0 + (an - AN_PF0));
+            else if (an == AN_HIRES)
+                playfield = COLOR_HIRES;
+
+            UINT8 classes[4] = { COLOR_BK, COLOR_BK, COLOR_BK, COLOR_BK };
+            if ((players & 0x03) == 0x03 && multiColor)
+                classes[CLASS_P01] = COLOR_PM01;
+            else if (players & 0x01)
+                classes[CLASS_P01] = COLOR_PM0;
+            else if (players & 0x02)
+                classes[CLASS_P01] = COLOR_PM1;
+            if ((players & 0x0C) == 0x0C && multiColor)
+                classes[CLASS_P23] = COLOR_PM23;
+            else if (players & 0x04)
+                classes[CLASS_P23] = COLOR_PM2;
+            else if (players & 0x08)
+                classes[CLASS_P23] = COLOR_PM3;
+            if (playfield == COLOR_PF0 || playfield == COLOR_PF1)
+                classes[CLASS_PF01] = playfield;
+            else if (playfield != COLOR_BK)
+                classes[CLASS_PF23] = playfield;
+
+            UINT8 color = COLOR_BK;
+            for (INT32 i = 0; i < 4; i++) {
+                color = classes[PRIORITY_ORDERS[order][i]];
+                if (color != COLOR_BK)
+                    break;
+            }
+            priorityTable[an][objects] = color;
+        }
+    }
+    priorityTablePrior = (UINT8)(PRIOR & 0x3F);
+}
+
+void GTIA::renderObject(UINT8 object, UINT8 position, UINT8 grafx, UINT8 size)
+{
+    UINT8 pixelWidth = PLAYER_WIDTHS[size];
+    INT32 x = 2 * ((INT32)position - 0x30);
+
+    //paint the pixels for the compositor
+    UINT8 objectBit = (UINT8)(1 << object);
+    for (INT32 bit = 7; bit >= 0; bit--) {
+        if (grafx & (1 << bit)) {
+            INT32 start = (x < 0 ? 0 : x);
+            INT32 end = (x + pixelWidth > 320 ? 320 : x + pixelWidth);
+            for (INT32 i = start; i < end; i++)
+                objectLine[i] |= objectBit;
+        }
+        x += pixelWidth;
+    }
+
+    //and shift the expanded graphics into the bitmask of the line
+    UINT64* plane = objectPlanes[object];
+    memset(plane, 0, sizeof(objectPlanes[object]));
+    UINT64 pattern = EXPAND_GRAFX[size][grafx];
+    x = 2 * ((INT32)position - 0x30);
+    if (x < 0) {
+        if (x <= -64)
+            return;
+        pattern >>= -x;
+        x = 0;
+    }
+    if (x >= 320)
+        return;
+    UINT8 word = (UINT8)(x >> 6);
+    UINT8 shift = (UINT8)(x & 0x3F);
+    plane[word] = pattern << shift;
+    if (shift)
+        plane[word+1] = pattern >> (64 - shift);
+}
+
+BOOL GTIA::renderObjects()
+{
+    if (objectLineDirty) {
+        memset(objectLine, 0, sizeof(objectLine));
+        objectLineDirty = FALSE;
+    }
+
+    objectsPresent = 0;
+    for (INT32 i = 0; i < 4; i++) {
+        if (GRAFP[i]) {
+            renderObject((UINT8)i, HPOSP[i], GRAFP[i], SIZEP[i] & 0x03);
+            objectsPresent |= (UINT8)(0x01 << i);
         }
-        case 0x80:
-        {
-            if ((an0 & 0x04) == 0) {
-                imageBank[location] = COLBK;
-                imageBank[location+1] = COLBK;
+        //missile graphics are moved up to the top bits, where a player's
+        //leftmost pixels would be
+        UINT8 missile = (UINT8)(((GRAFM >> (i << 1)) & 0x03) << 6);
+        if (missile) {
+            renderObject((UINT8)(4+i), HPOSM[i], missile, (SIZEM >> (i << 1)) & 0x03);
+            objectsPresent |= (UINT8)(0x10 << i);
+        }
+    }
+    objectLineDirty = (objectsPresent != 0);
+    return objectLineDirty;
+}
+
+void GTIA::detectCollisions(const UINT8* playfield)
+{
+    //the playfield bitmasks are only built for words that an object covers
+    UINT64 playfieldPlanes[4][6];
+    UINT8 wordsBuilt = 0;
+    BOOL gtiaMode = (PRIOR & 0xC0) != 0;
+
+    for (INT32 object = 0; object < 8; object++) {
+        if (!(objectsPresent & (1 << object)))
+            continue;
+
+        const UINT64* plane = objectPlanes[object];
+        UINT8 playfieldHits = 0;
+        UINT8 playerHits = 0;
+        for (INT32 word = 0; word < 5; word++) {
+            if (!plane[word])
+                continue;
+
+            if (!gtiaMode && !(wordsBuilt & (1 << word))) {
+                //eight codes at a time, flagging the bytes that match each
+                //playfield register and packing the flags down to bits
+                UINT64 bits[4] = { 0, 0, 0, 0 };
+                for (INT32 chunk = 0; chunk < 8; chunk++) {
+                    UINT64 codes;
+                    memcpy(&codes, playfield + (word << 6) + (chunk << 3), 8);
+                    for (INT32 pf = 0; pf < 4; pf++)
+                        bits[pf] |= matchingPixels(codes, (UINT8)(AN_PF0 + pf)) << (chunk << 3);
+                    //the hi-res luminance collides as playfield 2
+                    bits[2] |= matchingPixels(codes, AN_HIRES) << (chunk << 3);
+                }
+                for (INT32 pf = 0; pf < 4; pf++)
+                    playfieldPlanes[pf][word] = bits[pf];
+                wordsBuilt |= (UINT8)(1 << word);
             }
-            else {
-                UINT8 an_palette[16] = { COLPM[0], COLPM[1], COLPM[2], COLPM[3],
-                        COLPF[0], COLPF[1], COLPF[2], COLPF[3],
-                        COLBK, COLBK, COLBK, COLBK,
-                        COLPF[0], COLPF[1], COLPF[2], COLPF[3] };
-                UINT8 color = an_palette[((an0 & 0x03) << 2) | (an1 & 0x03)];
-                imageBank[location] = color;
-                imageBank[location+1] = color;
+
+            if (!gtiaMode) {
+                for (INT32 pf = 0; pf < 4; pf++) {
+                    if (plane[word] & playfieldPlanes[pf][word])
+                        playfieldHits |= (UINT8)(1 << pf);
+                }
+            }
+            for (INT32 player = 0; player < 4; player++) {
+                if (player != object && (objectsPresent & (1 << player)) &&
+                        (plane[word] & objectPlanes[player][word]))
+                    playerHits |= (UINT8)(1 << player);
             }
-            break;
         }
-        case 0xC0:
-        {
-            UINT8 color = COLBK;
-            if ((an0 & 0x04) == 0)
-                color |= (an0 & 0x03) << 6;
-            if ((an1 & 0x04) == 0)
-                color |= (an1 & 0x03) << 4;
-            imageBank[location] = color;
-            imageBank[location+1] = color;
-            break;
+
+        if (object < 4) {
+            PPF[object] |= playfieldHits;
+            PPL[object] |= playerHits;
+        }
+        else {
+            MPF[object-4] |= playfieldHits;
+            MPL[object-4] |= playerHits;
         }
     }
 }
-*/
+
+void GTIA::compositeLine(UINT8* output, const UINT8* playfield)
+{
+    if ((PRIOR & 0x3F) != priorityTablePrior)
+        buildPriorityTable();
+
+    BOOL objects = renderObjects();
+    if (objects)
+        detectCollisions(playfield);
+
+    UINT8 colors[COLOR_COUNT] = {
+        COLBK, COLPF[0], COLPF[1], COLPF[2], COLPF[3],
+        COLPM[0], COLPM[1], COLPM[2], COLPM[3],
+        (UINT8)(COLPM[0] | COLPM[1]), (UINT8)(COLPM[2] | COLPM[3]),
+        (UINT8)((COLPF[2] & 0xF0) | (COLPF[1] & 0x0F)) };
+
+    if (PRIOR & 0xC0) {
+        //the gtia color modes; objects are drawn over the playfield as if
+        //it were background
+        UINT8 gtiaColors[16];
+        switch (PRIOR & 0xC0) {
+            case 0x40:
+                //sixteen luminances of the background hue
+                for (INT32 i = 0; i < 16; i++)
+                    gtiaColors[i] = (UINT8)(COLBK | i);
+                break;
+            case 0x80:
+            {
+                //nine color registers
+                const UINT8 registerColors[16] = {
+                    COLPM[0], COLPM[1], COLPM[2], COLPM[3],
+                    COLPF[0], COLPF[1], COLPF[2], COLPF[3],
+                    COLBK, COLBK, COLBK, COLBK,
+                    COLPF[0], COLPF[1], COLPF[2], COLPF[3] };
+                memcpy(gtiaColors, registerColors, sizeof(gtiaColors));
+                break;
+            }
+            default:
+                //sixteen hues at the background luminance
+                for (INT32 i = 0; i < 16; i++)
+                    gtiaColors[i] = (UINT8)(COLBK | (i << 4));
+                break;
+        }
+
+        for (INT32 x = 0; x < 320; x++) {
+            UINT8 color = (objects ? priorityTable[AN_BK][objectLine[x]] : COLOR_BK);
+            output[x] = (color == COLOR_BK ? gtiaColors[playfield[x] & 0x0F] : colors[color]);
+        }
+        return;
+    }
+
+    if (!objects) {
+        //nothing but playfield on this line
+        UINT8 playfieldColors[8];
+        for (INT32 an = 0; an < 8; an++)
+            playfieldColors[an] = colors[priorityTable[an][0]];
+        for (INT32 x = 0; x < 320; x++)
+            output[x] = playfieldColors[playfield[x] & 0x07];
+        return;
+    }
+
+    for (INT32 x = 0; x < 320; x++)
+        output[x] = colors[priorityTable[playfield[x] & 0x07][objectLine[x]]];
+}
+
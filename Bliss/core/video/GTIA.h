@@ -5,6 +5,28 @@
 #include "GTIA_Registers.h"
 #include "core/cpu/Processor.h"
 
+TYPEDEF_STRUCT_PACK( _GTIAState
+{
+    UINT8 HPOSP[4];
+    UINT8 HPOSM[4];
+    UINT8 SIZEP[4];
+    UINT8 GRAFP[4];
+    UINT8 COLPM[4];
+    UINT8 COLPF[4];
+    UINT8 MPF[4];
+    UINT8 PPF[4];
+    UINT8 MPL[4];
+    UINT8 PPL[4];
+    UINT8 TRIG[4];
+    UINT8 SIZEM;
+    UINT8 GRAFM;
+    UINT8 COLBK;
+    UINT8 PRIOR;
+    UINT8 VDELAY;
+    UINT8 GRACTL;
+    UINT8 CONSOL;
+} GTIAState; )
+
 class GTIA : public Processor
 {
     friend class GTIA_Registers;
@@ -19,15 +41,50 @@ public:
 
     INT32 tick(INT32 minimum) { return minimum; }
 
-    //this function accepts four half-clocks from the Antic and processes them.
-    //in some GTIA modes, some of the half-clocks are ignored
-    //void process(UINT16 location, UINT8 an0, UINT8 an1, UINT8 an2, UINT8 an3);
+    /**
+     * Resolves one line of playfield codes from the Antic (ANBK, ANPFn, or
+     * the hi-res luminance code; raw 4-bit pixels in the GTIA color modes)
+     * together with the current players and missiles into 320 colors.
+     */
+    void compositeLine(UINT8* output, const UINT8* playfield);
+
+    GTIAState getState();
+    void setState(GTIAState state);
     
     GTIA_Registers registers;
 
 private:
+    void buildPriorityTable();
+    BOOL renderObjects();
+    void renderObject(UINT8 object, UINT8 position, UINT8 grafx, UINT8 size);
+    void detectCollisions(const UINT8* playfield);
+    static void initExpansionTables();
+
+    const static UINT8 PLAYER_WIDTHS[4];
+    const static UINT8 PRIORITY_ORDERS[5][4];
+
+    /**
+     * The player/missile graphics expanded to one bit per pixel for each
+     * size, leftmost pixel in the lowest bit, ready to be shifted into place.
+     */
+    static UINT64 EXPAND_GRAFX[4][256];
+
     UINT8 imageBank[320*240];
 
+    //the players (bits 0-3) and missiles (bits 4-7) covering each pixel
+    UINT8 objectLine[320];
+    BOOL  objectLineDirty;
+
+    //the same objects as bitmasks of the line, one bit per pixel; the sixth
+    //word catches whatever spills past the right edge
+    UINT64 objectPlanes[8][6];
+    UINT8  objectsPresent;
+
+    //the color selected for each playfield code and object combination,
+    //rebuilt whenever the priority bits of PRIOR change
+    UINT8 priorityTable[8][256];
+    UINT8 priorityTablePrior;
+
     UINT8 HPOSP[4];
     UINT8 HPOSM[4];
     UINT8 SIZEP[4];
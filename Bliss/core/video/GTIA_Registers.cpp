@@ -107,7 +107,11 @@ void GTIA_Registers::poke(UINT16 addr, UINT16 value)
             gtia->GRACTL = (UINT8)value;
             break;
         case 0x1E:
-            //TODO: clear the collision registers
+            //HITCLR
+            memset(gtia->MPF, 0, sizeof(gtia->MPF));
+            memset(gtia->PPF, 0, sizeof(gtia->PPF));
+            memset(gtia->MPL, 0, sizeof(gtia->MPL));
+            memset(gtia->PPL, 0, sizeof(gtia->PPL));
             break;
         case 0x1F:
             gtia->CONSOL = (UINT8)value;
@@ -9,36 +9,73 @@ VideoBus::VideoBus()
     pixelBufferRowSize(0),
     pixelBufferWidth(0),
     pixelBufferHeight(0),
-    videoProducerCount(0)
+    backIndex(0),
+    frontIndex(1),
+    readyIndex(2),
+    videoProducerCount(0),
+    frameData(NULL),
+    frameDataSize(0),
+    frameDataUsed(0)
 {
+    memset(frameBuffers, 0, sizeof(frameBuffers));
 }
 
 VideoBus::~VideoBus()
 {
-    if (pixelBuffer) {
-        delete[] pixelBuffer;
+    if (frameBuffers[0]) {
+        delete[] frameBuffers[0];
     }
 
-    for (UINT32 i = 0; i < videoProducerCount; i++)
+    for (UINT32 i = 0; i < videoProducerCount; i++) {
+        videoProducers[i]->setFrameData(NULL);
         videoProducers[i]->setPixelBuffer(NULL, 0);
+    }
+    delete[] frameData;
 }
 
 void VideoBus::addVideoProducer(VideoProducer* p)
 {
     videoProducers[videoProducerCount] = p;
-    videoProducers[videoProducerCount]->setPixelBuffer(pixelBuffer, pixelBufferRowSize);
+    frameDataOffsets[videoProducerCount] = frameDataUsed;
+    frameDataUsed += (p->getFrameDataSize() + 7) & ~7;
     videoProducerCount++;
+
+    if (frameDataUsed > frameDataSize) {
+        //grow the blocks, keeping what the other producers have written
+        UINT8* grown = new UINT8[frameDataUsed * 3];
+        memset(grown, 0, frameDataUsed * 3);
+        for (UINT32 i = 0; i < 3 && frameData; i++)
+            memcpy(grown + (i * frameDataUsed), frameData + (i * frameDataSize), frameDataSize);
+        UINT8* old = frameData;
+        frameData = grown;
+        frameDataSize = frameDataUsed;
+
+        //move every producer over to the new blocks before the old go away
+        setProducerPixelBuffers();
+        delete[] old;
+    }
+    else {
+        p->setFrameData(pixelBuffer ? getProducerFrameData(videoProducerCount-1, backIndex) : NULL);
+        p->setPixelBuffer(pixelBuffer, pixelBufferRowSize);
+    }
 }
 
 void VideoBus::removeVideoProducer(VideoProducer* p)
 {
     for (UINT32 i = 0; i < videoProducerCount; i++) {
         if (videoProducers[i] == p) {
+			videoProducers[i]->setFrameData(NULL);
 			videoProducers[i]->setPixelBuffer(NULL, 0);
 
-            for (UINT32 j = i; j < (videoProducerCount-1); j++)
+            for (UINT32 j = i; j < (videoProducerCount-1); j++) {
                 videoProducers[j] = videoProducers[j+1];
+                frameDataOffsets[j] = frameDataOffsets[j+1];
+            }
             videoProducerCount--;
+
+            //the space is reclaimed once every producer has gone
+            if (videoProducerCount == 0)
+                frameDataUsed = 0;
             return;
         }
     }
@@ -58,35 +95,107 @@ void VideoBus::init(UINT32 width, UINT32 height)
 	pixelBufferHeight = height;
 	pixelBufferRowSize = width * sizeof(UINT32);
 	pixelBufferSize = width * height * sizeof(UINT32);
-	pixelBuffer = new UINT32[width * height];
 
-	if ( pixelBuffer ) {
-		memset(pixelBuffer, 0, pixelBufferSize);
-	}
+	//allocate all three frames in a single block
+	frameBuffers[0] = new UINT32[width * height * 3];
+	if (frameBuffers[0] == NULL)
+		return;
 
-	for (UINT32 i = 0; i < videoProducerCount; i++)
-		videoProducers[i]->setPixelBuffer(pixelBuffer, pixelBufferRowSize);
+	memset(frameBuffers[0], 0, pixelBufferSize * 3);
+	frameBuffers[1] = frameBuffers[0] + (width * height);
+	frameBuffers[2] = frameBuffers[1] + (width * height);
+
+	backIndex = 0;
+	frontIndex = 1;
+	readyIndex.store(2);
+	pixelBuffer = frameBuffers[backIndex];
+
+	setProducerPixelBuffers();
 }
 
 void VideoBus::render()
 {
     //tell each of the video producers that they can now output their
     //video contents onto the video device
-    for (UINT32 i = 0; i < videoProducerCount; i++)
+    BOOL frameChanged = FALSE;
+    for (UINT32 i = 0; i < videoProducerCount; i++) {
         videoProducers[i]->render();
+        if (videoProducers[i]->hasFrameChanged())
+            frameChanged = TRUE;
+    }
+
+    //nothing new to show, so leave the last published frame in place
+    if (!pixelBuffer || !frameChanged)
+        return;
+
+    //publish the completed frame and take back whichever buffer was
+    //published before it, which the front end has not claimed
+    backIndex = readyIndex.exchange(backIndex | FRAME_FRESH, std::memory_order_acq_rel) & 0x03;
+    pixelBuffer = frameBuffers[backIndex];
+    setProducerPixelBuffers();
+}
+
+const UINT32* VideoBus::getFrame()
+{
+    if (!frameBuffers[0])
+        return NULL;
+
+    //only swap if a new frame has been published since the last call
+    if (readyIndex.load(std::memory_order_acquire) & FRAME_FRESH)
+        frontIndex = readyIndex.exchange(frontIndex, std::memory_order_acq_rel) & 0x03;
+
+    return frameBuffers[frontIndex];
+}
+
+BOOL VideoBus::hasNewFrame()
+{
+    return (readyIndex.load(std::memory_order_acquire) & FRAME_FRESH) != 0;
+}
+
+const void* VideoBus::getFrameData(VideoProducer* p)
+{
+    if (!frameBuffers[0])
+        return NULL;
+
+    for (UINT32 i = 0; i < videoProducerCount; i++) {
+        if (videoProducers[i] == p)
+            return getProducerFrameData(i, frontIndex);
+    }
+    return NULL;
+}
+
+void* VideoBus::getProducerFrameData(UINT32 producer, UINT32 frame)
+{
+    if (!frameData || videoProducers[producer]->getFrameDataSize() == 0)
+        return NULL;
+
+    //each frame buffer has its own block, so the data is published and
+    //claimed along with the pixels by the same exchange of the ready index
+    return frameData + (frame * frameDataSize) + frameDataOffsets[producer];
 }
 
 void VideoBus::release()
 {
-	if (pixelBuffer) {
-		for (UINT32 i = 0; i < videoProducerCount; i++)
+	if (frameBuffers[0]) {
+		for (UINT32 i = 0; i < videoProducerCount; i++) {
+			videoProducers[i]->setFrameData(NULL);
 			videoProducers[i]->setPixelBuffer(NULL, 0);
+		}
 
 		pixelBufferWidth = 0;
 		pixelBufferHeight = 0;
 		pixelBufferRowSize = 0;
 		pixelBufferSize = 0;
-		delete[] pixelBuffer;
+		delete[] frameBuffers[0];
+		memset(frameBuffers, 0, sizeof(frameBuffers));
 		pixelBuffer = NULL;
 	}
 }
+
+void VideoBus::setProducerPixelBuffers()
+{
+	for (UINT32 i = 0; i < videoProducerCount; i++) {
+		videoProducers[i]->setFrameData(pixelBuffer ? getProducerFrameData(i, backIndex) : NULL);
+		videoProducers[i]->setPixelBuffer(pixelBuffer, pixelBufferRowSize);
+	}
+}
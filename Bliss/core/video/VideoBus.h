@@ -2,11 +2,24 @@
 #ifndef VIDEOBUS_H
 #define VIDEOBUS_H
 
+#include <atomic>
 #include "core/types.h"
 #include "VideoProducer.h"
 
 const INT32 MAX_VIDEO_PRODUCERS = 10;
 
+/**
+ * The video bus owns three frame buffers.  The video producers always render
+ * into the back buffer; render() publishes the back buffer with a single
+ * atomic exchange and hands the producers the buffer that was published
+ * before it.  The front end calls getFrame() to take the most recently
+ * published frame, which it may then read without copying or locking until
+ * its next call to getFrame().  Each frame buffer also carries a block of
+ * data for the producers that keep some with every frame, which is swapped
+ * along with the pixels.  The back buffer still holds whatever frame was last
+ * drawn into it, so a producer that does not repaint every pixel must keep
+ * track of the frame it drew last and carry the rest over itself.
+ */
 class VideoBus
 {
     public:
@@ -21,6 +34,33 @@ class VideoBus
         virtual void render();
         virtual void release();
 
+        /**
+         * Takes ownership of the most recently published frame, releasing the
+         * frame returned by the previous call.  May be called from a thread
+         * other than the one running the emulation.
+         *
+         * @return the latest complete frame, or NULL if video is not initialized
+         */
+        const UINT32* getFrame();
+
+        /**
+         * Indicates whether a frame has been published since the last call to
+         * getFrame().  This is FALSE when the video producers reported that
+         * nothing on the screen changed, in which case the frame returned by
+         * the last call to getFrame() is still current.
+         */
+        BOOL hasNewFrame();
+
+        /**
+         * Returns the data the given video producer keeps with the frame
+         * returned by the last call to getFrame(), or NULL if it keeps none.
+         */
+        const void* getFrameData(VideoProducer* p);
+
+        UINT32 getFrameWidth() { return pixelBufferWidth; }
+        UINT32 getFrameHeight() { return pixelBufferHeight; }
+        UINT32 getFrameRowSize() { return pixelBufferRowSize; }
+
     protected:
         UINT32*				pixelBuffer;
         UINT32				pixelBufferSize;
@@ -29,9 +69,28 @@ class VideoBus
         UINT32				pixelBufferHeight;
 
     private:
+        void setProducerPixelBuffers();
+        void* getProducerFrameData(UINT32 producer, UINT32 frame);
+
+        //the low two bits of the ready index select the buffer, and the
+        //FRAME_FRESH bit is set when it has not yet been taken by getFrame()
+        static const UINT32 FRAME_FRESH = 0x04;
+
+        UINT32*               frameBuffers[3];
+        UINT32                backIndex;
+        UINT32                frontIndex;
+        std::atomic<UINT32>   readyIndex;
+
         VideoProducer*        videoProducers[MAX_VIDEO_PRODUCERS];
         UINT32                videoProducerCount;
 
+        //the data the producers keep with each frame, one block per frame
+        //buffer, with each producer at its own offset within the block
+        UINT8*                frameData;
+        UINT32                frameDataSize;
+        UINT32                frameDataUsed;
+        UINT32                frameDataOffsets[MAX_VIDEO_PRODUCERS];
+
 };
 
 #endif
@@ -22,6 +22,28 @@ class VideoProducer
 		virtual void setPixelBuffer(UINT32* pixelBuffer, UINT32 rowSize) = 0;
 
 		virtual void render() = 0;
+
+        /**
+         * Indicates whether the video producer has drawn anything into the
+         * back buffer since the last call to render().  When no producer has,
+         * the video bus does not publish the back buffer, so that front ends
+         * can skip uploading an identical frame.
+         */
+		virtual BOOL hasFrameChanged() { return TRUE; }
+
+        /**
+         * Returns the number of bytes of data the video producer keeps with
+         * each frame.  The video bus allocates that much alongside each of its
+         * frame buffers and publishes it with the frame, so that the front end
+         * always reads the data that belongs to the frame it is showing.
+         */
+		virtual UINT32 getFrameDataSize() { return 0; }
+
+        /**
+         * Gives the video producer its data for the frame in the back buffer.
+         * The video bus calls this just before each call to setPixelBuffer().
+         */
+		virtual void setFrameData(void* frameData) {}
 };
 
 #endif
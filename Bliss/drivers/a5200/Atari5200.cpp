@@ -3,7 +3,7 @@
 
 Atari5200::Atari5200()
     : Emulator("Atari 5200"),
-      ram(0x4000, 0x0000),
+      ram(A5200_RAM_SIZE, 0x0000),
       leftInput(3, "Left JoyPad"),
       rightInput(4, "Right JoyPad"),
       pokey(&leftInput, &rightInput),
@@ -20,8 +20,12 @@ Atari5200::Atari5200()
     antic.connectPinOut(ANTIC_PIN_OUT_READY, &cpu, _6502C_PIN_IN_READY);
     pokey.connectPinOut(POKEY_PIN_OUT_IRQ, &cpu, _6502C_PIN_IN_IRQ);
 
-    //add the 16K of 8-bit RAM
+    //add the 16K of 8-bit RAM, watched by the Antic so that it can reuse
+    //the display list it compiled until the program changes it, and read
+    //directly by the cpu for its zero page and stack
     AddRAM(&ram);
+    antic.setWatchedRAM(&ram);
+    cpu.setDirectPages(&ram);
 
     //add the BIOS ROM
     AddROM(&biosROM);
@@ -44,28 +48,287 @@ Atari5200::Atari5200()
     //add the joypads
     AddInputConsumer(&leftInput);
     AddInputConsumer(&rightInput);
+
+    memset(&state, 0, sizeof(Atari5200State));
+}
+
+void Atari5200::SaveState()
+{
+    state.header.emu = FOURCHAR('EMUS');
+    state.header.state = FOURCHAR('TATE');
+    state.header.emuID = ID_EMULATOR_BLISS;
+    state.header.version = FOURCHAR(EMU_STATE_VERSION);
+    state.header.sys = FOURCHAR('SYS\0');
+    state.header.sysID = ID_SYSTEM_ATARI5200;
+    state.header.cart = FOURCHAR('CART');
+    state.header.cartID = currentRip->GetCRC();
+
+    state.cpu.id = FOURCHAR('CPU\0');
+    state.cpu.size = sizeof(_6502cState);
+    state.cpuState = cpu.getState();
+
+    state.antic.id = FOURCHAR('ANTC');
+    state.antic.size = sizeof(AnticState);
+    state.anticState = antic.getState();
+
+    state.gtia.id = FOURCHAR('GTIA');
+    state.gtia.size = sizeof(GTIAState);
+    state.gtiaState = gtia.getState();
+
+    state.pokey.id = FOURCHAR('POKY');
+    state.pokey.size = sizeof(PokeyState);
+    state.pokeyState = pokey.getState();
+
+    state.mainRAM.id = FOURCHAR('RAM0');
+    state.mainRAM.size = sizeof(RAMState) + sizeof(state.mainRAMImage);
+    state.mainRAMState = ram.getState(state.mainRAMImage);
+
+    state.eof.id = FOURCHAR('EOF\0');
+    state.eof.size = sizeof(Atari5200State);
+}
+
+BOOL Atari5200::LoadState()
+{
+    if (!isStateValid(&state)) {
+        return FALSE;
+    }
+
+    cpu.setState(state.cpuState);
+    antic.setState(state.anticState);
+    gtia.setState(state.gtiaState);
+    pokey.setState(state.pokeyState);
+    ram.setState(state.mainRAMState, state.mainRAMImage);
+
+    //the image was copied in behind the watchers' backs, so the display
+    //list the Antic compiled from the old RAM can no longer be trusted
+    ram.markAllWritten();
+
+    return TRUE;
+}
+
+BOOL Atari5200::isStateValid(const Atari5200State* state)
+{
+    if (state->header.emu != FOURCHAR('EMUS') || state->header.state != FOURCHAR('TATE')) {
+        return FALSE;
+    }
+
+    if (state->header.emuID != ID_EMULATOR_BLISS) {
+        return FALSE;
+    }
+
+    if (FOURCHAR(EMU_STATE_VERSION) != FOURCHAR('dev\0') && state->header.version != FOURCHAR('dev\0') && state->header.version != FOURCHAR(EMU_STATE_VERSION)) {
+        return FALSE;
+    }
+
+    if (state->header.sys != FOURCHAR('SYS\0')) {
+        return FALSE;
+    }
+
+    if (state->header.sysID != ID_SYSTEM_ATARI5200) {
+        return FALSE;
+    }
+
+    if (state->header.cart != FOURCHAR('CART')) {
+        return FALSE;
+    }
+
+    if (state->header.cartID != 0x00000000 && state->header.cartID != currentRip->GetCRC()) {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+BOOL Atari5200::SaveState(Atari5200State* outState)
+{
+    SaveState();
+
+    memcpy(outState, &state, sizeof(Atari5200State));
+
+    return TRUE;
+}
+
+BOOL Atari5200::LoadState(const Atari5200State* inState)
+{
+    if (!isStateValid(inState)) {
+        return FALSE;
+    }
+
+    memcpy(&state, inState, sizeof(Atari5200State));
+
+    return LoadState();
 }
 
 BOOL Atari5200::SaveStateBuffer(void* outBuffer, size_t bufferSize)
 {
-    printf("Atari5200::SaveStateBuffer is not implemented\n");
-    return FALSE;
+    Atari5200State *bufferState = (Atari5200State*)outBuffer;
+
+    if(!outBuffer || bufferSize < sizeof(Atari5200State)) {
+        return FALSE;
+    }
+
+    return SaveState(bufferState);
 }
 
 BOOL Atari5200::LoadStateBuffer(const void* inBuffer, size_t bufferSize)
 {
-    printf("Atari5200::LoadStateBuffer is not implemented\n");
-    return FALSE;
+    Atari5200State *bufferState = (Atari5200State*)inBuffer;
+
+    if(!inBuffer || bufferSize < sizeof(Atari5200State)) {
+        return FALSE;
+    }
+
+    return LoadState(bufferState);
 }
 
 BOOL Atari5200::SaveStateFile(const CHAR* filename)
 {
-    printf("Atari5200::SaveStateFile is not implemented\n");
-    return FALSE;
+    BOOL didSave = FALSE;
+    size_t totalStateSize = sizeof(Atari5200State);
+
+    // save the current state internally
+    SaveState();
+
+    FILE* file = fopen(filename, "wb");
+
+    if (file == NULL) {
+        printf("Error: Unable to create file %s\n", filename);
+        didSave = FALSE;
+    }
+
+    if (file != NULL && totalStateSize == fwrite(&state, 1, totalStateSize, file)) {
+        didSave = TRUE;
+    } else {
+        printf("Error: could not write %zu bytes to file %s\n", totalStateSize, filename);
+        didSave = FALSE;
+    }
+
+    if (file) {
+        fclose(file);
+        file = NULL;
+    }
+
+    return didSave;
 }
 
 BOOL Atari5200::LoadStateFile(const CHAR* filename)
 {
-    printf("Atari5200::LoadStateFile is not implemented\n");
-    return FALSE;
+    BOOL didLoadState = FALSE;
+    BOOL isParsing = FALSE;
+    StateChunk chunk = {0};
+
+    //the RAM image makes this too large to keep on the stack
+    Atari5200State* fileState = new Atari5200State;
+    memset(fileState, 0, sizeof(Atari5200State));
+
+    FILE* file = fopen(filename, "rb");
+
+    if (file == NULL) {
+        printf("Error: Unable to open file %s\n", filename);
+        delete fileState;
+        return FALSE;
+    }
+
+    // read in the header
+    if (sizeof(StateHeader) != fread(fileState, 1, sizeof(StateHeader), file)) {
+        printf("Error: could not read state header (%zu bytes) from file %s\n", sizeof(StateHeader), filename);
+        goto close;
+    }
+
+    // validate file header
+    if (fileState->header.emu != FOURCHAR('EMUS') || fileState->header.state != FOURCHAR('TATE')) {
+        printf("Error: invalid header in file %s\n", filename);
+        goto close;
+    }
+
+    if (fileState->header.emuID != ID_EMULATOR_BLISS) {
+        printf("Error: invalid emulator ID %x in file %s\n", fileState->header.emuID, filename);
+        goto close;
+    }
+
+    if (FOURCHAR(EMU_STATE_VERSION) != FOURCHAR('dev\0') && fileState->header.version != FOURCHAR('dev\0') && fileState->header.version != FOURCHAR(EMU_STATE_VERSION)) {
+        printf("Error: invalid emulator version 0x%08x (expected 0x%08x) in file %s\n", fileState->header.version, EMU_STATE_VERSION, filename);
+        goto close;
+    }
+
+    if (fileState->header.sys != FOURCHAR('SYS\0')) {
+        printf("Error: expected 'SYS ' chunk in file %s\n", filename);
+        goto close;
+    }
+
+    if (fileState->header.sysID != ID_SYSTEM_ATARI5200) {
+        printf("Error: invalid system ID %x in file %s\n", fileState->header.sysID, filename);
+        goto close;
+    }
+
+    if (fileState->header.cart != FOURCHAR('CART')) {
+        printf("Error: expected 'CART' chunk in file %s\n", filename);
+        goto close;
+    }
+
+    if (fileState->header.cartID != 0x00000000 && fileState->header.cartID != currentRip->GetCRC()) {
+        printf("Error: cartridge mismatch in file %s\n", filename);
+        goto close;
+    }
+
+    isParsing = TRUE;
+    while (isParsing) {
+        if (sizeof(StateChunk) != fread(&chunk, 1, sizeof(StateChunk), file)) {
+            isParsing = FALSE;
+            break;
+        }
+
+        switch (chunk.id) {
+            default:
+                fseek(file, chunk.size, SEEK_CUR);
+                break;
+            case FOURCHAR('CPU\0'):
+                if (chunk.size == sizeof(fileState->cpuState)) {
+                    fileState->cpu = chunk;
+                    fread(&fileState->cpuState, 1, fileState->cpu.size, file);
+                }
+                break;
+            case FOURCHAR('ANTC'):
+                if (chunk.size == sizeof(fileState->anticState)) {
+                    fileState->antic = chunk;
+                    fread(&fileState->anticState, 1, fileState->antic.size, file);
+                }
+                break;
+            case FOURCHAR('GTIA'):
+                if (chunk.size == sizeof(fileState->gtiaState)) {
+                    fileState->gtia = chunk;
+                    fread(&fileState->gtiaState, 1, fileState->gtia.size, file);
+                }
+                break;
+            case FOURCHAR('POKY'):
+                if (chunk.size == sizeof(fileState->pokeyState)) {
+                    fileState->pokey = chunk;
+                    fread(&fileState->pokeyState, 1, fileState->pokey.size, file);
+                }
+                break;
+            case FOURCHAR('RAM0'):
+                if (chunk.size == sizeof(fileState->mainRAMState) + sizeof(fileState->mainRAMImage)) {
+                    fileState->mainRAM = chunk;
+                    fread(&fileState->mainRAMState, 1, fileState->mainRAM.size, file);
+                }
+                break;
+            case FOURCHAR('EOF\0'):
+                fileState->eof = chunk;
+                isParsing = FALSE;
+                break;
+        }
+    }
+
+    didLoadState = TRUE;
+
+close:
+    fclose(file);
+    file = NULL;
+
+    if (didLoadState) {
+        didLoadState = LoadState(fileState);
+    }
+
+    delete fileState;
+    return didLoadState;
 }
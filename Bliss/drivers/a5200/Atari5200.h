@@ -5,19 +5,37 @@
 #include "core/Emulator.h"
 #include "core/cpu/SignalLine.h"
 #include "core/cpu/6502c.h"
-#include "core/memory/RAM.h"
+#include "core/memory/WatchedRAM.h"
 #include "core/memory/ROM.h"
 #include "core/video/Antic.h"
 #include "core/video/GTIA.h"
 #include "core/audio/Pokey.h"
 #include "JoyPad.h"
 
+#define A5200_RAM_SIZE  0x4000
+
+TYPEDEF_STRUCT_PACK( _Atari5200State
+{
+    StateHeader          header;
+    StateChunk           cpu;
+    _6502cState          cpuState;
+    StateChunk           antic;
+    AnticState           anticState;
+    StateChunk           gtia;
+    GTIAState            gtiaState;
+    StateChunk           pokey;
+    PokeyState           pokeyState;
+    StateChunk           mainRAM;
+    RAMState             mainRAMState;
+    UINT16               mainRAMImage[A5200_RAM_SIZE];
+    StateChunk           eof;
+} Atari5200State; )
+
 class Atari5200 : public Emulator
 {
 
     public:
         Atari5200();
-#if 0
         void SaveState();
         BOOL LoadState();
 
@@ -25,14 +43,14 @@ class Atari5200 : public Emulator
 
         BOOL SaveState(Atari5200State* outState);
         BOOL LoadState(const Atari5200State *inState);
-#endif
+
         BOOL SaveStateBuffer(void* outBuffer, size_t bufferSize);
         BOOL LoadStateBuffer(const void* inBuffer, size_t bufferSize);
 
         BOOL SaveStateFile(const CHAR* filename);
         BOOL LoadStateFile(const CHAR* filename);
 
-        inline size_t StateSize() { return 0; }
+        inline size_t StateSize() { return sizeof(Atari5200State); }
 
     private:
         JoyPad      leftInput;
@@ -43,7 +61,9 @@ class Atari5200 : public Emulator
         Pokey       pokey;
 
         ROM         biosROM;
-        RAM         ram;
+        WatchedRAM  ram;
+
+        Atari5200State state;
 
 };
 
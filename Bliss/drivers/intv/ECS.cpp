@@ -26,7 +26,7 @@ ECS::ECS()
     AddRAM(&uart);
 
     AddProcessor(&psg2);
-    AddAudioProducer(&psg2);
+    AddAudioProducer(&psg2, ECS_PSG2_PAN);
     AddRAM(&psg2.registers);
 
     AddInputConsumer(&keyboard);
@@ -13,6 +13,10 @@
 
 #define ECS_RAM_SIZE    0x0800
 
+//the second PSG sits toward the right of a stereo mix, so that it can be
+//told apart from the one in the console
+#define ECS_PSG2_PAN    0.5f
+
 TYPEDEF_STRUCT_PACK( _ECSState
 {
     RAMState     ramState;
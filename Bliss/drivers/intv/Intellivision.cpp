@@ -43,7 +43,8 @@ Intellivision::Intellivision()
     //add the executive ROM
     AddROM(&execROM);
 
-    //add the GROM
+    //add the GROM, which the STIC hides from the cpu during active display
+    grom.SetSwitchable(TRUE);
     AddROM(&grom);
 
     //add the GRAM
@@ -76,8 +77,18 @@ Intellivision::Intellivision()
     memset(&state, 0, sizeof(IntellivisionState));
 }
 
+void Intellivision::SetHalfHeightVideo(BOOL halfHeight)
+{
+    stic.setHalfHeightOutput(halfHeight);
+    videoHeight = (halfHeight ? 96 : 192);
+}
+
 void Intellivision::SaveState()
 {
+    //the audio thread holds the current state of the sound chips
+    BOOL asyncAudio = IsAsyncAudio();
+    SetAsyncAudio(FALSE);
+
     state.header.emu = FOURCHAR('EMUS');
     state.header.state = FOURCHAR('TATE');
     state.header.emuID = ID_EMULATOR_BLISS;
@@ -123,6 +134,8 @@ void Intellivision::SaveState()
 
     state.eof.id = FOURCHAR('EOF\0');
     state.eof.size = sizeof(IntellivisionState);
+
+    SetAsyncAudio(asyncAudio);
 }
 
 BOOL Intellivision::LoadState()
@@ -131,6 +144,9 @@ BOOL Intellivision::LoadState()
         return FALSE;
     }
 
+    BOOL asyncAudio = IsAsyncAudio();
+    SetAsyncAudio(FALSE);
+
     cpu.setState(state.cpuState);
     stic.setState(state.sticState);
     psg.setState(state.psgState);
@@ -140,6 +156,8 @@ BOOL Intellivision::LoadState()
     intellivoice.setState(state.ivoiceState);
     ecs.setState(state.ecsState);
 
+    SetAsyncAudio(asyncAudio);
+
     return TRUE;
 }
 
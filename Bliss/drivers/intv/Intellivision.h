@@ -63,6 +63,19 @@ class Intellivision : public Emulator
 
         inline size_t StateSize() { return sizeof(IntellivisionState); }
 
+        /**
+         * Switches the STIC between the doubled 160x192 output and its native
+         * 160x96 output, adjusting the reported video height to match.  This
+         * must be called before the video bus is initialized.
+         */
+        void SetHalfHeightVideo(BOOL halfHeight);
+
+        /**
+         * Gets the STIC, which reports the rows of a half-height frame whose
+         * odd lines differ from the even lines.
+         */
+        AY38900* GetSTIC() { return &stic; }
+
     private:
         //core processors
         CP1610            cpu;
@@ -38,9 +38,6 @@
 #import "drivers/intv/HandController.h"
 #import "drivers/intv/ECSKeyboard.h"
 
-#define INTV_IMAGE_WIDTH	(160)
-#define INTV_IMAGE_HEIGHT	(192)
-
 #define KEYBOARD_OBJECT_COUNT 256
 #define AUDIO_SAMPLE_RATE 48000
 
@@ -89,23 +86,17 @@ public:
 	void		init(UINT32 sampleRate);
 	void		release();
 	void		flushAudio();
-};
 
-class BlissVideoBus : public VideoBus
-{
-public:
-	void		init(UINT32 width, UINT32 height);
-	void		release();
-	void		render();
+private:
+	UINT32		targetBufferedSamples;
 };
 
 @interface BlissGameCore () <OEIntellivisionSystemResponderClient>
 {
 	NSLock			*_bufferLock;
 	OERingBuffer	*_audioBuffer;
-	unsigned char	*_videoBuffer;
 	BlissAudioMixer	*_audioMixer;
-	BlissVideoBus	*_videoBus;
+	VideoBus		*_videoBus;
 
     NSString		*_ROMName;
 	Emulator		*currentEmu;
@@ -141,7 +132,7 @@ static uint8_t _keyboardShiftCount = 0;
 		_currentCore = self;
 
 		_audioMixer = new BlissAudioMixer;
-		_videoBus = new BlissVideoBus;
+		_videoBus = new VideoBus;
 
 		_stateData = [NSMutableData dataWithLength:sizeof(IntellivisionState)];
     }
@@ -421,11 +412,18 @@ static uint8_t _keyboardShiftCount = 0;
 
 	// hook up the audio and video
 	currentEmu->InitVideo(_videoBus, currentEmu->GetVideoWidth(), currentEmu->GetVideoHeight());
-	currentEmu->InitAudio(_audioMixer, AUDIO_SAMPLE_RATE);
+	currentEmu->InitAudio(_audioMixer, AUDIO_SAMPLE_RATE, TRUE);
 
 	// put the RIP in the currentEmulator
 	currentEmu->SetRip(currentRip);
 
+	// some cartridges rewrite the backtab while the STIC is displaying it
+	Intellivision *intellivision = dynamic_cast<Intellivision*>(currentEmu);
+	if(intellivision)
+	{
+		intellivision->GetSTIC()->setRowAccurate(currentRip->IsRowAccurateVideo());
+	}
+
 	// finally, run everything
 	currentEmu->Reset();
 
@@ -458,22 +456,23 @@ static uint8_t _keyboardShiftCount = 0;
 
 - (OEIntSize)bufferSize
 {
-    return OEIntSizeMake(INTV_IMAGE_WIDTH, INTV_IMAGE_HEIGHT);
+    return OEIntSizeMake(currentEmu->GetVideoWidth(), currentEmu->GetVideoHeight());
 }
 
 - (OEIntRect)screenRect
 {
-    return OEIntRectMake(0, 0, INTV_IMAGE_WIDTH, INTV_IMAGE_HEIGHT);
+    return OEIntRectMake(0, 0, currentEmu->GetVideoWidth(), currentEmu->GetVideoHeight());
 }
 
 - (OEIntSize)aspectSize
 {
-    return OEIntSizeMake(INTV_IMAGE_WIDTH * (12.0/7.0), INTV_IMAGE_HEIGHT);
+    return OEIntSizeMake(currentEmu->GetVideoWidth() * (12.0/7.0), currentEmu->GetVideoHeight());
 }
 
 - (const void *)videoBuffer
 {
-    return _videoBuffer;
+	// borrow the latest complete frame; it stays valid until the next call
+	return _videoBus->getFrame();
 }
 
 - (GLenum)pixelFormat
@@ -500,7 +499,7 @@ static uint8_t _keyboardShiftCount = 0;
 
 - (NSUInteger)channelCount
 {
-	return 1;
+	return _audioMixer->getChannelCount();
 }
 
 - (double)audioSampleRate
@@ -604,8 +603,11 @@ void BlissAudioMixer::init(UINT32 sampleRate)
 
 	if(_currentCore->_audioBuffer)
 	{
-		[_currentCore->_audioBuffer setLength:(sizeof(INT16) * sampleInterval * 8)];
+		[_currentCore->_audioBuffer setLength:(sizeof(INT16) * getChannelCount() * sampleInterval * 8)];
 	}
+
+	// keep about two frames of audio queued ahead of the output device
+	targetBufferedSamples = sampleInterval * 2;
 }
 
 void BlissAudioMixer::release()
@@ -615,43 +617,21 @@ void BlissAudioMixer::release()
 
 void BlissAudioMixer::flushAudio()
 {
-	NSUInteger bytesPerSample = sizeof(INT16);
-	NSUInteger bytesToWrite = sampleCount * bytesPerSample;
+	NSUInteger bytesPerFrame = sizeof(INT16) * getChannelCount();
+	NSUInteger bytesToWrite = sampleCount * bytesPerFrame;
 
 	[_currentCore->_bufferLock lock];
 	[_currentCore->_audioBuffer write:this->sampleBuffer maxLength:bytesToWrite];
+	NSUInteger bufferedSamples = [_currentCore->_audioBuffer usedBytes] / bytesPerFrame;
 	[_currentCore->_bufferLock unlock];
 
+	// nudge the output rate to hold the queue steady against the device clock
+	setBufferFill((UINT32)bufferedSamples, targetBufferedSamples);
+
 	// updates buffer write position and sample count
 	AudioMixer::flushAudio();
 }
 
-#pragma mark Bliss Video Bus
-
-void BlissVideoBus::init(UINT32 width, UINT32 height)
-{
-	VideoBus::init(width, height);
-
-	_currentCore->_videoBuffer = new unsigned char[256 * 256 * 4];
-}
-
-void BlissVideoBus::release()
-{
-	delete[] _currentCore->_videoBuffer;
-	_currentCore->_videoBuffer = NULL;
-
-	VideoBus::release();
-}
-
-void BlissVideoBus::render()
-{
-	VideoBus::render();
-
-	[_currentCore->_bufferLock lock];
-	memcpy(_currentCore->_videoBuffer, this->pixelBuffer, this->pixelBufferSize);
-	[_currentCore->_bufferLock unlock];
-}
-
 #pragma mark Bliss Input Producer
 
 BlissInputProducer::BlissInputProducer()